@@ -1,5 +1,7 @@
 #include "Engine.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #include <SDL2/SDL.h>
@@ -14,6 +16,8 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 
 #include <ExperimEngineConfig.h>
+#include <engine/jobs/JobSystem.hpp>
+#include <engine/profiling/Profiler.hpp>
 #include <engine/render/Renderer.hpp>
 #include <engine/render/Window.hpp>
 #include <engine/render/wgpu/WGpuRenderer.hpp>
@@ -24,12 +28,23 @@ namespace {
 const int DEFAULT_WINDOW_WIDTH = 1280;
 const int DEFAULT_WINDOW_HEIGHT = 720;
 const float ONE_SEC_IN_MILLI_F = 1000.0f;
+/* Messages waiting for the log writer thread */
+const size_t ASYNC_LOG_QUEUE_CAPACITY = 8192;
 
 } // namespace
 
 namespace experim {
 
-Engine::Engine(const std::string& appName, const uint32_t appVersion)
+Engine::Engine(
+    const std::string& appName,
+    const uint32_t appVersion,
+    EngineCreateFlags createFlags)
+    : ticking_(false)
+    , fixedTickDuration_(0.0f)
+    , tickAccumulator_(0.0f)
+    , maxCatchUpTicks_(DEFAULT_MAX_CATCH_UP_TICKS)
+    , replayPace_(ReplayPace::eUnthrottled)
+    , stopOnReplayEnd_(true)
 {
     /* ------------------------------------------- */
     /* Initialize logging                          */
@@ -37,13 +52,7 @@ Engine::Engine(const std::string& appName, const uint32_t appVersion)
 
     try
     {
-        logger_ = std::make_shared<spdlog::logger>(LOGGER_NAME);
-        logger_->set_level(spdlog::level::trace);
-        logger_->flush_on(spdlog::level::err);
-        /* Globally register the loggers. Accessible with spdlog::get */
-        spdlog::register_logger(logger_);
-        /* Default accessible as spdlog::info() */
-        spdlog::set_default_logger(logger_);
+        std::vector<spdlog::sink_ptr> sinks;
 
 #ifndef __EMSCRIPTEN__
         /* In native, redirect logs to a file */
@@ -51,30 +60,70 @@ Engine::Engine(const std::string& appName, const uint32_t appVersion)
             LOG_FILE, 1024 * 1024 * 5, 3, true);
         /* https://github.com/gabime/spdlog/issues/1318 */
         fileSink->set_level(spdlog::level::info);
-        logger_->sinks().push_back(fileSink);
+        sinks.push_back(fileSink);
 #endif // __EMSCRIPTEN__
 
 #ifndef NDEBUG
         /* In debug, also redirect logs to standard ouput */
         auto stdoutSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
         stdoutSink->set_level(spdlog::level::trace);
-        logger_->sinks().push_back(stdoutSink);
+        sinks.push_back(stdoutSink);
 #endif // NDEBUG
+
+#ifndef __EMSCRIPTEN__
+        /* Formatting and I/O are moved to a writer thread, the logging threads
+         * only queue the messages */
+        if (createFlags & EngineCreateFlagBits::eAsyncLogging)
+        {
+            asyncLogSink_ = std::make_shared<AsyncLogSink>(
+                std::move(sinks), ASYNC_LOG_QUEUE_CAPACITY);
+            sinks = {asyncLogSink_};
+        }
+#endif // __EMSCRIPTEN__
+
+        logger_ = std::make_shared<spdlog::logger>(
+            LOGGER_NAME, sinks.begin(), sinks.end());
+        logger_->set_level(spdlog::level::trace);
+        logger_->flush_on(spdlog::level::err);
+        /* Globally register the loggers. Accessible with spdlog::get */
+        spdlog::register_logger(logger_);
+        /* Default accessible as spdlog::info() */
+        spdlog::set_default_logger(logger_);
     } catch (const spdlog::spdlog_ex& ex)
     {
         std::cout << "Log initialization failed : " << ex.what() << std::endl;
         throw ex;
     }
 
+    /* ------------------------------------------- */
+    /* Initialize profiling & job system           */
+    /* ------------------------------------------- */
+    Profiler::get().setThreadName("Main thread");
+    jobSystem_ = std::make_unique<JobSystem>();
+
     /* ------------------------------------------- */
     /* Initialize SDL components                   */
     /* ------------------------------------------- */
-    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_GAMECONTROLLER);
+    const bool headless = bool(createFlags & EngineCreateFlagBits::eHeadless);
+    if (headless)
+    {
+        /* Only the event queue, no display is needed */
+        SDL_Init(SDL_INIT_EVENTS);
+    }
+    else
+    {
+        SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_GAMECONTROLLER);
+    }
 
     /* ------------------------------------------- */
     /* Initialize main window & renderer           */
     /* ------------------------------------------- */
 #ifdef __EMSCRIPTEN__
+    if (headless)
+    {
+        SPDLOG_LOGGER_WARN(
+            logger_, "Headless mode not supported by the WebGPU renderer, ignored");
+    }
     renderer_ = std::make_unique<webgpu::WebGpuRenderer>(
         appName,
         appVersion,
@@ -87,7 +136,9 @@ Engine::Engine(const std::string& appName, const uint32_t appVersion)
         appVersion,
         DEFAULT_WINDOW_WIDTH,
         DEFAULT_WINDOW_HEIGHT,
-        engineParams_);
+        engineParams_,
+        *jobSystem_,
+        headless);
 #endif
 
     mainWindow_ = renderer_->getMainWindow();
@@ -103,21 +154,115 @@ Engine::Engine(const std::string& appName, const uint32_t appVersion)
 Engine::~Engine()
 {
     SPDLOG_LOGGER_INFO(logger_, "ExperimEngine : cleaning resources");
+    /* Registered with the job system, which is destroyed before the renderer */
+    renderer_->setRenderThreadEnabled(false);
     SDL_Quit();
+    /* Joins the writer thread while the process is still running. The subsystems
+     * destroyed after this point log synchronously. */
+    if (asyncLogSink_)
+        asyncLogSink_->stop();
 }
 
 const IRendering& Engine::graphics() const { return *renderer_; }
 
+JobSystem& Engine::jobs() const { return *jobSystem_; }
+
 #ifdef __EMSCRIPTEN__
 void emscriptenTick(Engine* engine) { engine->tick(); }
 #endif
 
 void Engine::setTickRateLimit(float updatesPerSecond)
 {
-    if (updatesPerSecond == UNLIMITED_TICK_RATE)
-        tickTimer_.reset(0);
+    framePacer_.setTargetRate(updatesPerSecond);
+}
+
+void Engine::setFixedTickRate(float ticksPerSecond, uint32_t maxCatchUpTicks)
+{
+    if (ticksPerSecond == VARIABLE_TICK_RATE)
+        fixedTickDuration_ = 0.0f;
     else
-        tickTimer_.reset(Timer::DefaultResolution::den / updatesPerSecond);
+        fixedTickDuration_ = Timer::DefaultResolution::den / ticksPerSecond;
+
+    maxCatchUpTicks_ = std::max(1u, maxCatchUpTicks);
+    tickAccumulator_ = 0.0f;
+}
+
+void Engine::setRenderThreadEnabled(bool enabled)
+{
+    renderer_->setRenderThreadEnabled(enabled);
+}
+
+void Engine::setFrameReadback(const std::string& directory, uint32_t frameInterval)
+{
+    renderer_->setFrameReadback(directory, frameInterval);
+}
+
+void Engine::setFramesInFlight(uint32_t framesInFlight)
+{
+    renderer_->setFramesInFlight(framesInFlight);
+}
+
+void Engine::setGraphicSettings(const GraphicSettings& graphicSettings)
+{
+    renderer_->setGraphicSettings(graphicSettings);
+}
+
+void Engine::startRecording(const std::string& filePath)
+{
+    auto recorder = std::make_unique<InputRecorder>(filePath);
+    if (recorder->isOpen())
+        inputRecorder_ = std::move(recorder);
+}
+
+void Engine::stopRecording() { inputRecorder_.reset(); }
+
+void Engine::startReplay(
+    const std::string& filePath,
+    ReplayPace pace,
+    bool stopOnEnd)
+{
+    auto replayer = std::make_unique<InputReplayer>(filePath);
+    if (!replayer->isOpen())
+        return;
+
+    inputReplayer_ = std::move(replayer);
+    replayPace_ = pace;
+    stopOnReplayEnd_ = stopOnEnd;
+    replayTimer_.reset();
+}
+
+void Engine::endReplay()
+{
+    const double elapsed = replayTimer_.getElapsedTime<Milliseconds>();
+    const uint64_t frames = inputReplayer_->replayedFrames();
+    SPDLOG_LOGGER_INFO(
+        logger_,
+        "Input replay ended : {} frame(s) in {:.3f} ms, {:.2f} frames per second",
+        frames,
+        elapsed,
+        elapsed > 0.0 ? frames * ONE_SEC_IN_MILLI_F / elapsed : 0.0);
+
+    inputReplayer_.reset();
+    if (stopOnReplayEnd_)
+        ticking_ = false;
+}
+
+void Engine::setLogOverflowPolicy(LogOverflowPolicy overflowPolicy)
+{
+    if (asyncLogSink_)
+        asyncLogSink_->setOverflowPolicy(overflowPolicy);
+}
+
+AsyncLogStatistics Engine::loggingStatistics() const
+{
+    return asyncLogSink_ ? asyncLogSink_->statistics() : AsyncLogStatistics {};
+}
+
+void Engine::startProfilingCapture() { Profiler::get().startCapture(); }
+
+void Engine::stopProfilingCapture(const std::string& traceFilePath)
+{
+    Profiler::get().stopCapture(traceFilePath);
 }
 
 void Engine::run()
@@ -138,15 +283,16 @@ void Engine::run()
 
 void Engine::stop() { ticking_ = false; }
 
-bool Engine::tick()
+void Engine::gatherInput()
 {
-    /* Events */
+    EXPENGINE_PROFILE_ZONE("Engine::gatherInput");
+    frameInput_.events.clear();
+    liveWindowEvents_.clear();
+
     /* TODO : May wrap SDL event */
     SDL_Event event;
     while (SDL_PollEvent(&event))
     {
-        renderer_->handleEvent(event);
-
         /* SDL_QUIT is only present when the last window is closed.
          * Since we may have multiple windows, we check for our
          * main window close event too. */
@@ -159,46 +305,168 @@ bool Engine::tick()
             ticking_ = false;
         }
 
-        for (auto& eventHandler : onEvents_)
+        /* Live input is ignored while replaying, except for the window events :
+         * the windows must still follow their actual state */
+        if (!inputReplayer_)
+            frameInput_.events.push_back(event);
+        else if (event.type == SDL_WINDOWEVENT || event.type == SDL_QUIT)
+            liveWindowEvents_.push_back(event);
+    }
+
+    float deltaT = (float) (tickTimer_.getElapsedTime<Milliseconds>());
+    tickTimer_.reset();
+
+    if (inputReplayer_)
+    {
+        /* Replaces the events and the deltaT */
+        if (!inputReplayer_->next(frameInput_))
         {
-            eventHandler(event);
+            endReplay();
+            frameInput_.events.clear();
+            frameInput_.deltaT = deltaT;
+        }
+        frameInput_.events.insert(
+            frameInput_.events.end(),
+            liveWindowEvents_.begin(),
+            liveWindowEvents_.end());
+    }
+    else
+    {
+        frameInput_.deltaT = deltaT;
+    }
+
+    if (inputRecorder_)
+        inputRecorder_->record(frameInput_);
+}
+
+bool Engine::tick()
+{
+    EXPENGINE_PROFILE_ZONE("Engine::tick");
+    FrameTimeSample frameSample;
+    Timer phaseTimer;
+
+    /* Events */
+    gatherInput();
+    {
+        EXPENGINE_PROFILE_ZONE("Engine::handleEvents");
+        for (const auto& event : frameInput_.events)
+        {
+            renderer_->handleEvent(event);
+
+            for (auto& eventHandler : onEvents_)
+            {
+                eventHandler(event);
+            }
         }
     }
 
     prepareFrame();
 
-    float deltaT = (float) (tickTimer_.getElapsedTime<Milliseconds>());
-    tickTimer_.reset();
+    const float deltaT = frameInput_.deltaT;
 
     /* Updates */
     generateUI();
 
-    for (auto& tick : onTicks_)
+    updateSimulation(deltaT);
+
     {
-        tick(deltaT);
+        EXPENGINE_PROFILE_ZONE("Engine::frameHandlers");
+        for (auto& frameHandler : onFrames_)
+        {
+            frameHandler(engineParams_.timings.interpolationAlpha);
+        }
     }
+    frameSample[FrameMetric::eSimulation]
+        = phaseTimer.getElapsedTime<Milliseconds>();
 
     renderFrame();
+    frameSample[FrameMetric::eRecording] = engineParams_.timings.frameDuration
+        - engineParams_.timings.presentWaitDuration;
+    frameSample[FrameMetric::ePresentWait]
+        = engineParams_.timings.presentWaitDuration;
+
+    phaseTimer.reset();
 
     /* Limit framerate and updates */
-    if (!tickTimer_.isExpired())
+    if (!inputReplayer_ || replayPace_ == ReplayPace::eTickRateLimit)
     {
-        std::this_thread::sleep_for(std::chrono::milliseconds(
-            (long) tickTimer_.getTimeLeft<Milliseconds>()));
+        EXPENGINE_PROFILE_ZONE("Engine::framePacing");
+        framePacer_.wait();
     }
+    engineParams_.statistics.pacing = framePacer_.statistics();
+    frameSample[FrameMetric::ePacing] = phaseTimer.getElapsedTime<Milliseconds>();
+
+    frameSample[FrameMetric::eFrame]
+        = frameIntervalTimer_.getElapsedTime<Milliseconds>();
+    frameIntervalTimer_.reset();
+    engineParams_.statistics.frameTimes.addFrame(frameSample);
 
     return ticking_;
 }
 
-void Engine::prepareFrame() { renderer_->prepareFrame(); }
+void Engine::prepareFrame()
+{
+    EXPENGINE_PROFILE_ZONE("Engine::prepareFrame");
+    renderer_->prepareFrame();
+}
 
 void Engine::generateUI() { }
 
+void Engine::updateSimulation(float deltaT)
+{
+    EXPENGINE_PROFILE_ZONE("Engine::updateSimulation");
+    EngineTimings* timings = &engineParams_.timings;
+    EngineStatistics* stats = &engineParams_.statistics;
+
+    /* Variable tick rate : 1 tick per frame */
+    if (fixedTickDuration_ <= 0.0f)
+    {
+        for (auto& tick : onTicks_)
+        {
+            tick(deltaT);
+        }
+        stats->ticksLastFrame = 1;
+        timings->interpolationAlpha = 1.0f;
+        return;
+    }
+
+    /* Fixed tick rate : consume the elapsed time in fixed steps. Several steps may
+     * be needed to catch up after a long frame, none if the frame was short. */
+    tickAccumulator_ += deltaT;
+    uint32_t ticks = 0;
+    while (tickAccumulator_ >= fixedTickDuration_ && ticks < maxCatchUpTicks_)
+    {
+        for (auto& tick : onTicks_)
+        {
+            tick(fixedTickDuration_);
+        }
+        tickAccumulator_ -= fixedTickDuration_;
+        ticks++;
+    }
+
+    /* Still late after the allowed catch-up ticks : drop the simulation time left
+     * instead of spiraling into ever longer frames. */
+    if (tickAccumulator_ >= fixedTickDuration_)
+    {
+        auto droppedTicks
+            = static_cast<uint32_t>(tickAccumulator_ / fixedTickDuration_);
+        tickAccumulator_ -= droppedTicks * fixedTickDuration_;
+        stats->droppedTicks += droppedTicks;
+    }
+
+    stats->ticksLastFrame = ticks;
+    /* How far we are between the last simulated state and the next one */
+    timings->interpolationAlpha = tickAccumulator_ / fixedTickDuration_;
+}
+
 void Engine::renderFrame()
 {
     frameTimer_.reset();
 
-    renderer_->renderFrame();
+    {
+        EXPENGINE_PROFILE_ZONE("Engine::renderFrame");
+        renderer_->renderFrame();
+    }
 
     EngineTimings* timings = &engineParams_.timings;
     timings->frameDuration = frameTimer_.getElapsedTime<Milliseconds>();
@@ -208,20 +476,30 @@ void Engine::renderFrame()
 
     if (stats->fpsTimer.isExpired())
     {
-        stats->fpsValue = static_cast<uint32_t>(
-            (float) stats->frameCounter
-            * (ONE_SEC_IN_MILLI_F / stats->fpsRefreshPeriod)
-            * (stats->fpsTimer.getElapsedTime<Milliseconds>()
-               / stats->fpsRefreshPeriod));
+        /* Frames over the time actually elapsed, which is a bit longer than the
+         * refresh period */
+        stats->fpsValue = static_cast<uint32_t>(std::round(
+            stats->frameCounter * ONE_SEC_IN_MILLI_F
+            / stats->fpsTimer.getElapsedTime<Milliseconds>()));
+        auto frameTimes = stats->frameTimes.summary(FrameMetric::eFrame);
 
         SPDLOG_LOGGER_INFO(
             logger_,
             "Update FPS value : {:4} ; frames : {:3} ; timer : {:.5f}, "
-            "last frame duration : {:.3f} ms",
+            "last frame duration : {:.3f} ms (gpu : {:.3f} ms) ; frame time p50 : "
+            "{:.3f} ms, p99 : {:.3f} ms, stutters : {} ; pacing jitter avg : "
+            "{:.3f} ms, max : {:.3f} ms",
             stats->fpsValue,
             stats->frameCounter,
             timings->timer,
-            timings->frameDuration);
+            timings->frameDuration,
+            timings->gpu.frameDuration,
+            frameTimes.p50,
+            frameTimes.p99,
+            stats->frameTimes.stutterCount(),
+            stats->pacing.averageJitter,
+            stats->pacing.maxJitter);
+        framePacer_.resetPeakStatistics();
 
         stats->frameCounter = 0;
         stats->fpsTimer.reset();
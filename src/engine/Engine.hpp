@@ -7,29 +7,55 @@
 #include <SDL2/SDL_events.h>
 
 #include <engine/EngineParameters.hpp>
+#include <engine/log/AsyncLogSink.hpp>
 #include <engine/log/ExpengineLog.hpp>
 #include <engine/render/IRendering.hpp>
+#include <engine/utils/InputRecording.hpp>
 
 namespace experim {
 
 const float UNLIMITED_TICK_RATE = 0;
+const float VARIABLE_TICK_RATE = 0;
+const uint32_t DEFAULT_MAX_CATCH_UP_TICKS = 5;
+
+enum class ReplayPace
+{
+    /* Frames are paced by the tick rate limit, as in live mode */
+    eTickRateLimit,
+    /* Frames are executed as fast as possible, to measure throughput */
+    eUnthrottled
+};
 
 /* Forward declarations */
+class JobSystem;
 class Renderer;
 class Window;
 
 typedef std::function<void(float deltaT)> TickHandler;
+typedef std::function<void(float interpolationAlpha)> FrameHandler;
 typedef std::function<void(SDL_Event event)> EventHandler;
 
 class Engine {
 public:
-    Engine(const std::string& appName, const uint32_t appVersion);
+    Engine(
+        const std::string& appName,
+        const uint32_t appVersion,
+        EngineCreateFlags createFlags = {});
     ~Engine();
 
     template <class T> void onTick(T instance)
     {
         onTicks_.push_back([instance](float deltaT) { instance->onTick(deltaT); });
     };
+    /* Frame handlers are called exactly once per rendered frame, after the tick
+     * handlers. UI generation and render interpolation belong here when a fixed
+     * tick rate is used. */
+    template <class T> void onFrame(T instance)
+    {
+        onFrames_.push_back([instance](float interpolationAlpha) {
+            instance->onFrame(interpolationAlpha);
+        });
+    };
     template <class T> void onEvent(T instance)
     {
         onEvents_.push_back(
@@ -38,35 +64,121 @@ public:
 
     void run();
     void stop();
-    /* The default value UNLIMITED_TICK_RATE means unlimited tick rate. */
+    /* The default value UNLIMITED_TICK_RATE means unlimited tick rate. Otherwise,
+     * frames are paced to absolute deadlines. */
     void setTickRateLimit(float ticksPerSecond = UNLIMITED_TICK_RATE);
+    /* The default value VARIABLE_TICK_RATE calls the tick handlers once per frame
+     * with a variable deltaT. Any other value makes the tick handlers run at a
+     * fixed rate, with up to maxCatchUpTicks ticks per frame. */
+    void setFixedTickRate(
+        float ticksPerSecond = VARIABLE_TICK_RATE,
+        uint32_t maxCatchUpTicks = DEFAULT_MAX_CATCH_UP_TICKS);
+    /* When enabled, frame N is recorded and submitted on a render thread while
+     * frame N+1 is simulated. Disabled by default. */
+    void setRenderThreadEnabled(bool enabled);
+    /* Headless mode only. Every frameInterval frames, the rendered image is written
+     * to directory as a PPM file. An interval of 0 disables it. */
+    void setFrameReadback(const std::string& directory, uint32_t frameInterval);
+    /* Frames recorded by the CPU while the GPU renders the previous ones : 2 (the
+     * default) for a lower latency, 3 for a higher throughput. Clamped to [1, 4]. */
+    void setFramesInFlight(uint32_t framesInFlight);
+    /* Present mode, swapchain image count and dynamic resolution. Rebuilds the main
+     * window swapchain when they change, see presentation() for the values
+     * actually used. */
+    void setGraphicSettings(const GraphicSettings& graphicSettings);
+
+    /* Records the SDL events and the deltaT of every frame to filePath, until
+     * stopRecording is called. */
+    void startRecording(const std::string& filePath);
+    void stopRecording();
+    /* Replaces the live input and the wall-clock deltaT by a recording. Live events
+     * are discarded during the replay, except quit requests. */
+    void startReplay(
+        const std::string& filePath,
+        ReplayPace pace = ReplayPace::eUnthrottled,
+        bool stopOnEnd = true);
+    inline bool isReplaying() const { return inputReplayer_ != nullptr; };
+
+    /* Records the profiling zones of all the threads until stopProfilingCapture,
+     * which writes them to traceFilePath in the Chrome trace-event format. */
+    void startProfilingCapture();
+    void stopProfilingCapture(const std::string& traceFilePath);
+
+    inline const EngineTimings& timings() const { return engineParams_.timings; };
+    inline const GraphicSettings& graphicSettings() const
+    {
+        return engineParams_.graphicSettings;
+    };
+    /* Effective presentation of the main window, updated every frame */
+    inline const PresentationInfo& presentation() const
+    {
+        return engineParams_.presentation;
+    };
+    inline const EngineStatistics& statistics() const
+    {
+        return engineParams_.statistics;
+    };
 
     inline std::shared_ptr<spdlog::logger> getLogger() const { return logger_; };
+    /* Only used with EngineCreateFlagBits::eAsyncLogging */
+    void setLogOverflowPolicy(LogOverflowPolicy overflowPolicy);
+    AsyncLogStatistics loggingStatistics() const;
 
     /* Subsystems */
     IRendering& graphics() const;
+    /* Can be used from the tick and frame handlers to spread work across threads */
+    JobSystem& jobs() const;
 
 private:
     /* Owned objects */
     std::unique_ptr<Renderer> renderer_;
     std::shared_ptr<Window> mainWindow_;
+    /* Declared after the renderer : destroyed (and joined) before it, the jobs may
+     * still record with its objects. The render thread, registered with it, is
+     * stopped first. */
+    std::unique_ptr<JobSystem> jobSystem_;
 
     EngineParameters engineParams_;
     Timer frameTimer_;
     Timer tickTimer_;
+    /* Measures the full frame, from the end of the previous one */
+    Timer frameIntervalTimer_;
+    FramePacer framePacer_;
     bool ticking_;
+    /* Fixed tick rate. A duration of 0 means variable tick rate. */
+    float fixedTickDuration_;
+    float tickAccumulator_;
+    uint32_t maxCatchUpTicks_;
+
+    /* Input record & replay */
+    FrameInput frameInput_;
+    /* Live window events of the frame, forwarded along the replayed input */
+    std::vector<SDL_Event> liveWindowEvents_;
+    std::unique_ptr<InputRecorder> inputRecorder_;
+    std::unique_ptr<InputReplayer> inputReplayer_;
+    ReplayPace replayPace_;
+    bool stopOnReplayEnd_;
+    Timer replayTimer_;
 
     /* Logging */
     std::shared_ptr<spdlog::logger> logger_;
+    /* Null when logging synchronously */
+    std::shared_ptr<AsyncLogSink> asyncLogSink_;
 
     /* User callbacks */
     std::vector<TickHandler> onTicks_;
+    std::vector<FrameHandler> onFrames_;
     std::vector<EventHandler> onEvents_;
 
     void prepareFrame();
     void generateUI();
+    void updateSimulation(float deltaT);
     void renderFrame();
 
+    /** Fills frameInput_ with the live or the replayed input of this frame. */
+    void gatherInput();
+    void endReplay();
+
     /** Executes 1 engine tick. Returns false if the engine should stop. */
     bool tick();
 #ifdef __EMSCRIPTEN__
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
+#include <engine/utils/Flags.hpp>
+#include <engine/utils/FramePacer.hpp>
+#include <engine/utils/FrameTimeStatistics.hpp>
 #include <engine/utils/Timer.hpp>
 
 namespace {
@@ -10,12 +14,95 @@ const double DEFAULT_FPS_REFRESH_PERIOD = 1000.0;
 
 namespace experim {
 
+enum class EngineCreateFlagBits : uint32_t
+{
+    /* No window and no presentation : frames are rendered offscreen */
+    eHeadless = 1,
+    /* Log sinks are written by a background thread */
+    eAsyncLogging = 1 << 1
+};
+using EngineCreateFlags = Flags<EngineCreateFlagBits>;
+
+template <> struct FlagTraits<EngineCreateFlagBits> {
+    enum : uint32_t
+    {
+        allFlags = uint32_t(EngineCreateFlagBits::eHeadless)
+            | uint32_t(EngineCreateFlagBits::eAsyncLogging)
+    };
+};
+
+/* Presentation of the frames, unsupported modes fall back to the closest one */
+enum class PresentMode : uint32_t
+{
+    /* Vsync-locked : no tearing and the lowest power, but frames are queued */
+    eFifo,
+    /* No tearing, the latest frame replaces the queued one : limited latency */
+    eMailbox,
+    /* Frames are shown as soon as they are rendered : lowest latency, may tear */
+    eImmediate
+};
+
+/* Filter upscaling the scene of the main window to the window resolution */
+enum class UpscaleFilter : uint32_t
+{
+    eBilinear,
+    eNearest
+};
+
 struct GraphicSettings {
+    /** @brief Present mode of the windows, eMailbox by default. */
+    PresentMode presentMode = PresentMode::eMailbox;
+    /** @brief Minimum number of swapchain images, clamped to the surface limits.
+     * Fewer images queue fewer frames with eFifo, more images smooth out the frame
+     * time spikes. 0 requests one more than the surface minimum. */
+    uint32_t minImageCount = 0;
+    /** @brief GPU frame duration budget (in ms) of the main window. When set, the
+     * scene is rendered at a resolution scaled to meet it, then upscaled to the
+     * window. The UI stays at the window resolution. 0 disables dynamic
+     * resolution. Requires GPU timestamps. */
+    double targetGpuFrameDuration = 0.0;
+    /** @brief Lowest scale (per axis) of the scene resolution, up to 1.0. */
+    float minRenderScale = 0.5f;
+    UpscaleFilter upscaleFilter = UpscaleFilter::eBilinear;
+};
+
+struct PresentationInfo {
+    /** @brief Present mode used by the main window. May differ from the requested
+     * one when the surface does not support it. */
+    PresentMode presentMode = PresentMode::eFifo;
+    /** @brief Minimum image count the main window swapchain was created with. */
+    uint32_t minImageCount = 0;
+    /** @brief Image count of the main window swapchain, can exceed minImageCount.
+     * 0 when headless. */
+    uint32_t imageCount = 0;
+    /** @brief Scale (per axis) of the scene resolution of the main window. 1.0
+     * without dynamic resolution. */
+    float renderScale = 1.0f;
+};
+
+struct GpuFrameTimings {
+    /** @brief GPU duration (in milliseconds) from the start of the first render
+     * pass to the end of the last one. 0 if timestamps are not supported. */
+    double frameDuration = 0.0;
+    /** @brief GPU duration (in milliseconds) of each render pass, in recording
+     * order. Command buffers without a render pass are skipped. */
+    std::vector<double> passDurations;
+    /** @brief GPU duration (in milliseconds) of the scene pass, rendered at the
+     * scaled resolution. 0 without dynamic resolution. */
+    double sceneDuration = 0.0;
+};
+
+struct WindowGpuTimings {
+    uint32_t windowId = 0;
+    GpuFrameTimings timings;
 };
 
 struct EngineTimings {
     /** @brief Last frame duration (in milliseconds) */
     double frameDuration = 0.0;
+    /** @brief Part of frameDuration (in milliseconds) spent blocked on the GPU :
+     * waiting for a frame in flight to complete and for a swapchain image. */
+    double presentWaitDuration = 0.0;
     /** @brief Defines a frame rate independent timer value clamped from 0
      * to 1.0. */
     float timer = 0.0f;
@@ -24,6 +111,16 @@ struct EngineTimings {
     float timerSpeed = 1.0f;
     /** @brief Used to pause the global timer */
     bool paused = false;
+    /** @brief Fraction (from 0 to 1.0) of a fixed tick elapsed since the last
+     * simulated state. Used to interpolate rendering. Always 1.0 with a variable
+     * tick rate. */
+    float interpolationAlpha = 1.0f;
+    /** @brief GPU timings of the main window, from the latest frame completed by the
+     * GPU (a few frames behind frameDuration). */
+    GpuFrameTimings gpu;
+    /** @brief GPU timings of the additional windows (UI platform windows), same
+     * delay as gpu. */
+    std::vector<WindowGpuTimings> windowsGpu;
 };
 
 struct EngineStatistics {
@@ -35,6 +132,16 @@ struct EngineStatistics {
     uint32_t frameCounter = 0;
     /** @brief FPS value during the last second. */
     uint32_t fpsValue = 0;
+    /** @brief Number of ticks executed during the last frame. */
+    uint32_t ticksLastFrame = 0;
+    /** @brief Total number of fixed ticks skipped because the simulation could not
+     * catch up. */
+    uint64_t droppedTicks = 0;
+    /** @brief Accuracy of the frame rate limiter. */
+    FramePacingStatistics pacing;
+    /** @brief Rolling window of frame durations : percentiles, stutters and CSV
+     * export. */
+    FrameTimeStatistics frameTimes;
 
     EngineStatistics()
         : fpsTimer(DEFAULT_FPS_REFRESH_PERIOD)
@@ -45,6 +152,8 @@ struct EngineStatistics {
 struct EngineParameters {
     EngineStatistics statistics;
     EngineTimings timings;
+    GraphicSettings graphicSettings;
+    PresentationInfo presentation;
 };
 
 } // namespace experim
@@ -0,0 +1,294 @@
+#include "JobSystem.hpp"
+
+#include <algorithm>
+
+#include <engine/log/ExpengineLog.hpp>
+#include <engine/profiling/Profiler.hpp>
+
+namespace {
+
+/* 0 on threads not owned by a JobSystem, the worker index + 1 on workers, else
+ * an index given by registerThread */
+thread_local uint32_t t_threadIndex = 0;
+
+uint32_t defaultWorkerCount()
+{
+#ifdef __EMSCRIPTEN__
+    /* No threads without the pthread support of emscripten */
+    return 0;
+#else
+    /* The thread scheduling the jobs also executes some of them while waiting */
+    uint32_t hardwareThreads = std::thread::hardware_concurrency();
+    return std::max(1u, hardwareThreads > 1 ? hardwareThreads - 1 : 1u);
+#endif
+}
+
+} // namespace
+
+namespace experim {
+
+JobSystem::JobSystem()
+    : JobSystem(defaultWorkerCount())
+{
+}
+
+JobSystem::JobSystem(uint32_t workerCount)
+    : running_(true)
+    , queuedJobs_(0)
+    , nextQueue_(0)
+    , nextThreadIndex_(workerCount + 1)
+    , logger_(spdlog::get(LOGGER_NAME))
+{
+    /* At least one queue, used directly by the waiting threads when there is no
+     * worker */
+    for (uint32_t i = 0; i < std::max(1u, workerCount); i++)
+    {
+        queues_.push_back(std::make_unique<WorkQueue>());
+    }
+
+    for (uint32_t i = 0; i < workerCount; i++)
+    {
+        workers_.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+
+    SPDLOG_LOGGER_INFO(logger_, "JobSystem created with {} worker(s)", workerCount);
+}
+
+JobSystem::~JobSystem()
+{
+    SPDLOG_LOGGER_DEBUG(logger_, "JobSystem destruction");
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        running_ = false;
+    }
+    wakeCondition_.notify_all();
+
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+
+    if (queuedJobs_ > 0)
+    {
+        SPDLOG_LOGGER_WARN(
+            logger_, "JobSystem destroyed with {} job(s) not executed", queuedJobs_);
+    }
+}
+
+void JobSystem::registerThread()
+{
+    EXPENGINE_ASSERT(t_threadIndex == 0, "Thread already owned or registered");
+
+    std::lock_guard<std::mutex> lock(registeredMutex_);
+    if (!freeThreadIndices_.empty())
+    {
+        t_threadIndex = freeThreadIndices_.back();
+        freeThreadIndices_.pop_back();
+    }
+    else
+    {
+        t_threadIndex = nextThreadIndex_++;
+    }
+}
+
+void JobSystem::unregisterThread()
+{
+    EXPENGINE_ASSERT(
+        t_threadIndex > workers_.size(), "Thread not registered by registerThread");
+
+    std::lock_guard<std::mutex> lock(registeredMutex_);
+    freeThreadIndices_.push_back(t_threadIndex);
+    t_threadIndex = 0;
+}
+
+uint32_t JobSystem::threadIndex() { return t_threadIndex; }
+
+void JobSystem::schedule(Job job, JobCounter* signal)
+{
+    if (signal)
+        signal->pending_.fetch_add(1, std::memory_order_relaxed);
+
+    enqueue({.job = std::move(job), .signal = signal});
+}
+
+void JobSystem::schedule(Job job, JobCounter& dependency, JobCounter* signal)
+{
+    if (signal)
+        signal->pending_.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        /* The dependency can't reach 0 and release its continuations while we
+         * hold the lock */
+        std::lock_guard<std::mutex> lock(dependency.continuationsMutex_);
+        if (!dependency.isDone())
+        {
+            dependency.continuations_.push_back(
+                {.job = std::move(job), .signal = signal});
+            return;
+        }
+    }
+
+    enqueue({.job = std::move(job), .signal = signal});
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+    while (!counter.isDone())
+    {
+        if (!tryRunJob())
+            std::this_thread::yield();
+    }
+    /* Wait for the last signaling thread to release the counter */
+    std::lock_guard<std::mutex> lock(counter.continuationsMutex_);
+}
+
+void JobSystem::parallelFor(
+    uint32_t count,
+    uint32_t batchSize,
+    const RangeJob& rangeJob)
+{
+    EXPENGINE_ASSERT(batchSize > 0, "parallelFor called with a batch size of 0");
+
+    JobCounter counter;
+    for (uint32_t begin = 0; begin < count; begin += batchSize)
+    {
+        uint32_t end = std::min(count, begin + batchSize);
+        schedule([&rangeJob, begin, end]() { rangeJob(begin, end); }, &counter);
+    }
+    wait(counter);
+}
+
+void JobSystem::workerLoop(uint32_t workerIndex)
+{
+    t_threadIndex = workerIndex + 1;
+    Profiler::get().setThreadName(fmt::format("Job worker {}", t_threadIndex));
+
+    while (true)
+    {
+        if (tryRunJob())
+            continue;
+
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wakeCondition_.wait(lock, [this]() { return queuedJobs_ > 0 || !running_; });
+        if (!running_)
+            break;
+    }
+}
+
+bool JobSystem::ownsQueue() const
+{
+    return t_threadIndex > 0 && t_threadIndex <= workers_.size();
+}
+
+void JobSystem::enqueue(JobEntry&& entry)
+{
+    if (workers_.empty())
+    {
+        /* No worker to hand the job to */
+        execute(entry);
+        return;
+    }
+
+    /* Workers push to their own queue, other threads spread their jobs */
+    uint32_t queueIndex = ownsQueue()
+        ? t_threadIndex - 1
+        : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        /* Counted under the queue lock, as in popJob : the job can't be popped
+         * before it is counted */
+        std::lock_guard<std::mutex> lock(queues_[queueIndex]->mutex_);
+        queuedJobs_.fetch_add(1, std::memory_order_release);
+        queues_[queueIndex]->jobs_.push_back(std::move(entry));
+    }
+
+    {
+        /* Lock so that a worker can't miss the notification between its predicate
+         * check and its wait */
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+    }
+    wakeCondition_.notify_one();
+}
+
+bool JobSystem::popJob(JobEntry& entry)
+{
+    if (queuedJobs_.load(std::memory_order_acquire) == 0)
+        return false;
+
+    const uint32_t queueCount = static_cast<uint32_t>(queues_.size());
+
+    /* Own queue first, most recent job (still hot in cache) */
+    uint32_t ownQueue = 0;
+    if (ownsQueue())
+    {
+        ownQueue = t_threadIndex - 1;
+        auto& queue = *queues_[ownQueue];
+        std::lock_guard<std::mutex> lock(queue.mutex_);
+        if (!queue.jobs_.empty())
+        {
+            entry = std::move(queue.jobs_.back());
+            queue.jobs_.pop_back();
+            queuedJobs_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    else
+    {
+        ownQueue = nextQueue_.load(std::memory_order_relaxed) % queueCount;
+    }
+
+    /* Steal the oldest job of another queue */
+    for (uint32_t i = 0; i < queueCount; i++)
+    {
+        auto& queue = *queues_[(ownQueue + i) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex_);
+        if (!queue.jobs_.empty())
+        {
+            entry = std::move(queue.jobs_.front());
+            queue.jobs_.pop_front();
+            queuedJobs_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool JobSystem::tryRunJob()
+{
+    JobEntry entry;
+    if (!popJob(entry))
+        return false;
+
+    execute(entry);
+    return true;
+}
+
+void JobSystem::execute(JobEntry& entry)
+{
+    EXPENGINE_PROFILE_ZONE("JobSystem::execute");
+    entry.job();
+    signal(entry.signal);
+}
+
+void JobSystem::signal(JobCounter* counter)
+{
+    if (!counter)
+        return;
+
+    /* Decrement under the lock : a waiting thread locks it too before returning, so
+     * the counter can't be destroyed while we still use it. */
+    std::vector<JobEntry> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->continuationsMutex_);
+        if (counter->pending_.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+        /* Last job of the group : release the jobs depending on it */
+        continuations.swap(counter->continuations_);
+    }
+    for (auto& continuation : continuations)
+    {
+        enqueue(std::move(continuation));
+    }
+}
+
+} // namespace experim
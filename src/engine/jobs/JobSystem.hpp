@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spdlog {
+class logger;
+}
+
+namespace experim {
+
+class JobCounter;
+
+typedef std::function<void(void)> Job;
+typedef std::function<void(uint32_t begin, uint32_t end)> RangeJob;
+
+/** A job and the counter to decrement once it has been executed */
+struct JobEntry {
+    Job job;
+    JobCounter* signal = nullptr;
+};
+
+/** Counts the unfinished jobs of a group. A counter can be waited on, or be used as
+ * a dependency when scheduling other jobs. It must outlive the jobs it tracks. */
+class JobCounter {
+public:
+    JobCounter()
+        : pending_(0) {};
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    inline bool isDone() const
+    {
+        return pending_.load(std::memory_order_acquire) == 0;
+    };
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> pending_;
+    /* Jobs scheduled once this counter reaches 0 */
+    std::mutex continuationsMutex_;
+    std::vector<JobEntry> continuations_;
+};
+
+/** Work-stealing job scheduler. Each worker thread owns a queue : it pops its most
+ * recent jobs first and steals the oldest jobs of the other workers when its own
+ * queue is empty. Threads waiting on a counter execute jobs while they wait. */
+class JobSystem {
+public:
+    /** Creates one worker per hardware thread, minus the calling thread. */
+    JobSystem();
+    /** A workerCount of 0 executes the jobs inline, on the scheduling thread. */
+    explicit JobSystem(uint32_t workerCount);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    inline uint32_t workerCount() const { return (uint32_t) workers_.size(); };
+
+    /** Schedules a job. If signal is not null, it is incremented now and
+     * decremented when the job is done. */
+    void schedule(Job job, JobCounter* signal = nullptr);
+    /** Schedules a job that will only start once dependency is done. */
+    void schedule(Job job, JobCounter& dependency, JobCounter* signal = nullptr);
+    /** Blocks until counter is done. The calling thread executes pending jobs in
+     * the meantime. The counter can be destroyed once wait returns. */
+    void wait(JobCounter& counter);
+
+    /** Splits [0, count) in ranges of at most batchSize elements, executes them in
+     * parallel and returns once all of them are done. */
+    void parallelFor(uint32_t count, uint32_t batchSize, const RangeJob& rangeJob);
+
+    /** Gives the calling thread its own threadIndex(), above the ones of the
+     * workers. For threads recording per-thread data along with the workers, such
+     * as the render thread. The thread must unregister before it exits. */
+    void registerThread();
+    void unregisterThread();
+
+    /** Returns 0 on threads neither owned nor registered by a JobSystem, a value
+     * from 1 to workerCount() on worker threads, and a value above workerCount()
+     * unique among the registered threads on registered threads. */
+    static uint32_t threadIndex();
+
+private:
+    struct WorkQueue {
+        std::mutex mutex_;
+        std::deque<JobEntry> jobs_;
+    };
+
+    /* Owned objects */
+    std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+
+    /* Synchronization */
+    std::atomic<bool> running_;
+    std::atomic<uint32_t> queuedJobs_;
+    std::atomic<uint32_t> nextQueue_;
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+
+    /* Registered threads */
+    std::mutex registeredMutex_;
+    std::vector<uint32_t> freeThreadIndices_;
+    uint32_t nextThreadIndex_;
+
+    /* Logging */
+    std::shared_ptr<spdlog::logger> logger_;
+
+    void workerLoop(uint32_t workerIndex);
+
+    /* Only workers own a queue */
+    bool ownsQueue() const;
+    void enqueue(JobEntry&& entry);
+    /* Pops from the back of the queue owned by the calling thread, else steals from
+     * the front of the other queues. */
+    bool popJob(JobEntry& entry);
+    bool tryRunJob();
+    void execute(JobEntry& entry);
+    void signal(JobCounter* counter);
+};
+
+} // namespace experim
@@ -0,0 +1,237 @@
+#include "AsyncLogSink.hpp"
+
+#include <algorithm>
+
+namespace {
+
+const spdlog::level::level_enum DEFAULT_FLUSH_LEVEL = spdlog::level::warn;
+const std::chrono::milliseconds DEFAULT_FLUSH_INTERVAL(1000);
+
+} // namespace
+
+namespace experim {
+
+AsyncLogSink::AsyncLogSink(
+    std::vector<spdlog::sink_ptr> sinks,
+    size_t queueCapacity,
+    LogOverflowPolicy overflowPolicy)
+    : sinks_(std::move(sinks))
+    , queueCapacity_(std::max<size_t>(1, queueCapacity))
+    , overflowPolicy_(overflowPolicy)
+    , flushLevel_(DEFAULT_FLUSH_LEVEL)
+    , flushInterval_(DEFAULT_FLUSH_INTERVAL)
+    , flushRequests_(0)
+    , completedFlushes_(0)
+    , running_(true)
+    , peakQueuedMessages_(0)
+    , droppedMessages_(0)
+    , writtenMessages_(0)
+{
+    writer_ = std::thread(&AsyncLogSink::writerLoop, this);
+}
+
+AsyncLogSink::~AsyncLogSink() { stop(); }
+
+void AsyncLogSink::setOverflowPolicy(LogOverflowPolicy overflowPolicy)
+{
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    overflowPolicy_ = overflowPolicy;
+}
+
+void AsyncLogSink::setFlushPolicy(
+    spdlog::level::level_enum flushLevel,
+    std::chrono::milliseconds flushInterval)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        flushLevel_ = flushLevel;
+        flushInterval_ = flushInterval;
+    }
+    /* The writer may be waiting on the previous interval */
+    messagesAvailable_.notify_one();
+}
+
+AsyncLogStatistics AsyncLogSink::statistics() const
+{
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    return {
+        .queuedMessages = queue_.size(),
+        .peakQueuedMessages = peakQueuedMessages_,
+        .droppedMessages = droppedMessages_.load(std::memory_order_relaxed),
+        .writtenMessages = writtenMessages_.load(std::memory_order_relaxed)};
+}
+
+void AsyncLogSink::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (!running_)
+            return;
+        running_ = false;
+    }
+    messagesAvailable_.notify_all();
+    /* The writer empties the queue before exiting */
+    writer_.join();
+
+    for (auto& sink : sinks_)
+    {
+        sink->flush();
+    }
+    /* Releases the pending flush() calls */
+    batchWritten_.notify_all();
+}
+
+void AsyncLogSink::log(const spdlog::details::log_msg& msg)
+{
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    if (!running_)
+    {
+        /* No writer anymore : write in place */
+        lock.unlock();
+        write(msg);
+        return;
+    }
+
+    if (queue_.size() >= queueCapacity_)
+    {
+        switch (overflowPolicy_)
+        {
+        case LogOverflowPolicy::eBlock:
+            batchWritten_.wait(
+                lock, [this]() { return queue_.size() < queueCapacity_; });
+            break;
+        case LogOverflowPolicy::eDropOldest:
+            queue_.pop_front();
+            droppedMessages_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case LogOverflowPolicy::eDropNew:
+            droppedMessages_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    /* Copies the payload, the message only references the caller's buffers */
+    queue_.emplace_back(msg);
+    peakQueuedMessages_ = std::max<uint64_t>(peakQueuedMessages_, queue_.size());
+    lock.unlock();
+    messagesAvailable_.notify_one();
+}
+
+void AsyncLogSink::flush()
+{
+    {
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        if (running_)
+        {
+            /* The sinks are only used by the writer : it flushes them once the
+             * messages queued before the request are written */
+            const uint64_t request = ++flushRequests_;
+            messagesAvailable_.notify_one();
+            batchWritten_.wait(lock, [this, request]() {
+                return completedFlushes_ >= request || !running_;
+            });
+            return;
+        }
+    }
+    for (auto& sink : sinks_)
+    {
+        sink->flush();
+    }
+}
+
+void AsyncLogSink::set_pattern(const std::string& pattern)
+{
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    for (auto& sink : sinks_)
+    {
+        sink->set_pattern(pattern);
+    }
+}
+
+void AsyncLogSink::set_formatter(std::unique_ptr<spdlog::formatter> sinkFormatter)
+{
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    for (auto& sink : sinks_)
+    {
+        sink->set_formatter(sinkFormatter->clone());
+    }
+}
+
+void AsyncLogSink::writerLoop()
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::deque<spdlog::details::log_msg_buffer> batch;
+    /* Messages were written since the last flush */
+    bool unflushed = false;
+    auto lastFlush = Clock::now();
+    while (true)
+    {
+        uint64_t flushRequest;
+        bool flushRequested;
+        spdlog::level::level_enum flushLevel;
+        std::chrono::milliseconds flushInterval;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            auto awake = [this]() {
+                return !queue_.empty() || !running_
+                    || flushRequests_ > completedFlushes_;
+            };
+            /* Wakes up for the periodic flush of the written messages */
+            if (unflushed)
+                messagesAvailable_.wait_until(
+                    lock, lastFlush + flushInterval_, awake);
+            else
+                messagesAvailable_.wait(lock, awake);
+            if (queue_.empty() && !running_)
+                break;
+
+            /* Take every queued message at once : the logging threads get the
+             * whole queue capacity back */
+            batch.swap(queue_);
+            flushRequest = flushRequests_;
+            flushRequested = flushRequests_ > completedFlushes_;
+            flushLevel = flushLevel_;
+            flushInterval = flushInterval_;
+        }
+        batchWritten_.notify_all();
+
+        bool flush = flushRequested;
+        for (const auto& msg : batch)
+        {
+            write(msg);
+            flush = flush || msg.level >= flushLevel;
+        }
+        unflushed = unflushed || !batch.empty();
+        flush = flush || (unflushed && Clock::now() - lastFlush >= flushInterval);
+        if (flush)
+        {
+            for (auto& sink : sinks_)
+            {
+                sink->flush();
+            }
+            unflushed = false;
+            lastFlush = Clock::now();
+        }
+        writtenMessages_.fetch_add(batch.size(), std::memory_order_relaxed);
+        batch.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            if (flush)
+                completedFlushes_ = flushRequest;
+        }
+        batchWritten_.notify_all();
+    }
+}
+
+void AsyncLogSink::write(const spdlog::details::log_msg& msg)
+{
+    for (auto& sink : sinks_)
+    {
+        if (sink->should_log(msg.level))
+            sink->log(msg);
+    }
+}
+
+} // namespace experim
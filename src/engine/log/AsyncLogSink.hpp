@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <engine/log/ExpengineLog.hpp>
+#include <spdlog/details/log_msg_buffer.h>
+#include <spdlog/sinks/sink.h>
+
+namespace experim {
+
+enum class LogOverflowPolicy
+{
+    /* The logging thread waits for room in the queue */
+    eBlock,
+    /* The oldest queued message is discarded */
+    eDropOldest,
+    /* The new message is discarded */
+    eDropNew
+};
+
+struct AsyncLogStatistics {
+    /** @brief Messages currently waiting in the queue. */
+    uint64_t queuedMessages = 0;
+    /** @brief Highest number of messages waiting in the queue. */
+    uint64_t peakQueuedMessages = 0;
+    /** @brief Messages discarded because the queue was full. */
+    uint64_t droppedMessages = 0;
+    /** @brief Messages written by the background thread. */
+    uint64_t writtenMessages = 0;
+};
+
+/** Sink forwarding the messages to other sinks from a background thread. Logging
+ * threads only copy the message into a bounded queue : the formatting and the I/O
+ * of the wrapped sinks happen on the writer thread, which takes the queued messages
+ * in batches. The sinks are flushed on a level threshold or periodically, not after
+ * each batch. */
+class AsyncLogSink final : public spdlog::sinks::sink {
+public:
+    AsyncLogSink(
+        std::vector<spdlog::sink_ptr> sinks,
+        size_t queueCapacity,
+        LogOverflowPolicy overflowPolicy = LogOverflowPolicy::eDropOldest);
+    ~AsyncLogSink() override;
+
+    AsyncLogSink(const AsyncLogSink&) = delete;
+    AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+    void setOverflowPolicy(LogOverflowPolicy overflowPolicy);
+    /** The writer flushes the sinks after writing a message of flushLevel or above,
+     * and at most flushInterval after an unflushed write. Like spdlog flush_on and
+     * flush_every, without blocking the logging threads. */
+    void setFlushPolicy(
+        spdlog::level::level_enum flushLevel,
+        std::chrono::milliseconds flushInterval);
+    AsyncLogStatistics statistics() const;
+
+    /** Writes the queued messages and joins the writer thread. The following
+     * messages are written synchronously. */
+    void stop();
+
+    /* Implement spdlog::sinks::sink */
+    void log(const spdlog::details::log_msg& msg) override;
+    /** Blocks until the queued messages are written and the sinks flushed. */
+    void flush() override;
+    void set_pattern(const std::string& pattern) override;
+    void set_formatter(std::unique_ptr<spdlog::formatter> sinkFormatter) override;
+
+private:
+    /* Wrapped sinks, only used by the writer thread while it runs */
+    std::vector<spdlog::sink_ptr> sinks_;
+
+    /* Queue */
+    const size_t queueCapacity_;
+    std::deque<spdlog::details::log_msg_buffer> queue_;
+    LogOverflowPolicy overflowPolicy_;
+    mutable std::mutex queueMutex_;
+    /* Signaled when messages are queued, on a flush request, or on stop */
+    std::condition_variable messagesAvailable_;
+    /* Signaled when the writer frees room or finishes a batch */
+    std::condition_variable batchWritten_;
+
+    /* Flushing */
+    spdlog::level::level_enum flushLevel_;
+    std::chrono::milliseconds flushInterval_;
+    /* Explicit flush requests, served in order by the writer */
+    uint64_t flushRequests_;
+    uint64_t completedFlushes_;
+
+    /* Writer thread */
+    std::thread writer_;
+    bool running_;
+
+    /* Statistics */
+    uint64_t peakQueuedMessages_;
+    std::atomic<uint64_t> droppedMessages_;
+    std::atomic<uint64_t> writtenMessages_;
+
+    void writerLoop();
+    void write(const spdlog::details::log_msg& msg);
+};
+
+} // namespace experim
@@ -0,0 +1,222 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+#include <spdlog/fmt/fmt.h>
+
+#include <engine/log/ExpengineLog.hpp>
+
+namespace {
+
+/* Zones kept per thread : a few seconds of capture at the current zone density */
+const uint64_t THREAD_BUFFER_CAPACITY = 1 << 16;
+
+thread_local experim::ThreadProfileBuffer* t_profileBuffer = nullptr;
+
+/* Zone names are literals, but may come from __func__ */
+std::string escapeJson(const char* str)
+{
+    std::string escaped;
+    for (const char* c = str; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            escaped.push_back('\\');
+        escaped.push_back(*c);
+    }
+    return escaped;
+}
+
+} // namespace
+
+namespace experim {
+
+/* ------------------------------------------- */
+/* ThreadProfileBuffer                         */
+/* ------------------------------------------- */
+
+ThreadProfileBuffer::ThreadProfileBuffer(
+    uint32_t threadId,
+    const std::string& threadName)
+    : threadId_(threadId)
+    , threadName_(threadName)
+    , writeIndex_(0)
+    , captureStartIndex_(0)
+{
+}
+
+void ThreadProfileBuffer::record(const ProfileZoneRecord& zone)
+{
+    /* Allocated on the first zone only, many threads never record any */
+    if (zones_.empty())
+        zones_.resize(THREAD_BUFFER_CAPACITY);
+
+    const uint64_t index = writeIndex_.load(std::memory_order_relaxed);
+    zones_[index % THREAD_BUFFER_CAPACITY] = zone;
+    writeIndex_.store(index + 1, std::memory_order_release);
+}
+
+uint64_t ThreadProfileBuffer::read(
+    uint64_t fromIndex,
+    std::vector<ProfileZoneRecord>& records) const
+{
+    const uint64_t endIndex = writeIndex_.load(std::memory_order_acquire);
+    if (endIndex == 0)
+        return fromIndex;
+
+    uint64_t beginIndex = fromIndex;
+    if (endIndex > THREAD_BUFFER_CAPACITY)
+        beginIndex = std::max(beginIndex, endIndex - THREAD_BUFFER_CAPACITY);
+
+    const size_t firstRecord = records.size();
+    for (uint64_t index = beginIndex; index < endIndex; index++)
+    {
+        records.push_back(zones_[index % THREAD_BUFFER_CAPACITY]);
+    }
+
+    /* The owning thread kept writing while we copied : drop the copies of the slots
+     * that may have been reused meanwhile (including the one being written). */
+    const uint64_t writeIndexAfter = writeIndex_.load(std::memory_order_acquire);
+    if (writeIndexAfter >= THREAD_BUFFER_CAPACITY)
+    {
+        const uint64_t firstValidIndex = writeIndexAfter - THREAD_BUFFER_CAPACITY + 1;
+        if (firstValidIndex > beginIndex)
+        {
+            const uint64_t overwritten
+                = std::min(firstValidIndex, endIndex) - beginIndex;
+            records.erase(
+                records.begin() + firstRecord,
+                records.begin() + firstRecord + overwritten);
+        }
+    }
+
+    return endIndex;
+}
+
+/* ------------------------------------------- */
+/* Profiler                                    */
+/* ------------------------------------------- */
+
+Profiler& Profiler::get()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler()
+    : capturing_(false)
+{
+}
+
+void Profiler::startCapture()
+{
+    if (!logger_)
+        logger_ = spdlog::get(LOGGER_NAME);
+
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    for (auto& buffer : buffers_)
+    {
+        buffer->captureStartIndex_ = buffer->writeIndex();
+    }
+    captureStart_ = Timer::Clock::now();
+    capturing_.store(true, std::memory_order_relaxed);
+
+    SPDLOG_LOGGER_INFO(logger_, "Profiling capture started");
+}
+
+void Profiler::stopCapture(const std::string& filePath)
+{
+    if (!isCapturing())
+        return;
+    capturing_.store(false, std::memory_order_relaxed);
+
+    std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+    {
+        SPDLOG_LOGGER_ERROR(logger_, "Failed to open profiling trace {}", filePath);
+        return;
+    }
+
+    /* Chrome trace-event format : complete events ("X"), in microseconds. Nested
+     * zones are deduced from the timestamps. */
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool firstEvent = true;
+    size_t zoneCount = 0;
+    std::vector<ProfileZoneRecord> records;
+
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    for (auto& buffer : buffers_)
+    {
+        file << (firstEvent ? "" : ",")
+             << fmt::format(
+                    "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                    "\"args\":{{\"name\":\"{}\"}}}}",
+                    buffer->threadId(),
+                    escapeJson(buffer->threadName().c_str()));
+        firstEvent = false;
+
+        records.clear();
+        buffer->read(buffer->captureStartIndex_, records);
+        for (const auto& zone : records)
+        {
+            /* Started before the capture (the buffer wrapped around) */
+            if (zone.start < captureStart_)
+                continue;
+            std::chrono::duration<double, std::micro> start
+                = zone.start - captureStart_;
+            std::chrono::duration<double, std::micro> duration
+                = zone.end - zone.start;
+            file << fmt::format(
+                ",{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},"
+                "\"dur\":{:.3f}}}",
+                escapeJson(zone.name),
+                buffer->threadId(),
+                start.count(),
+                duration.count());
+            zoneCount++;
+        }
+    }
+    file << "]}";
+
+    SPDLOG_LOGGER_INFO(
+        logger_,
+        "Profiling capture written to {} : {} zone(s) on {} thread(s)",
+        filePath,
+        zoneCount,
+        buffers_.size());
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+    if (!t_profileBuffer)
+    {
+        t_profileBuffer = &registerThread(name);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    t_profileBuffer->threadName_ = name;
+}
+
+void Profiler::record(const ProfileZoneRecord& zone)
+{
+    threadBuffer().record(zone);
+}
+
+ThreadProfileBuffer& Profiler::threadBuffer()
+{
+    if (!t_profileBuffer)
+        t_profileBuffer = &registerThread("");
+    return *t_profileBuffer;
+}
+
+ThreadProfileBuffer& Profiler::registerThread(const std::string& threadName)
+{
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    const auto threadId = static_cast<uint32_t>(buffers_.size()) + 1;
+    buffers_.push_back(std::make_unique<ThreadProfileBuffer>(
+        threadId,
+        threadName.empty() ? fmt::format("Thread {}", threadId) : threadName));
+    return *buffers_.back();
+}
+
+} // namespace experim
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <engine/utils/Timer.hpp>
+
+namespace spdlog {
+class logger;
+}
+
+/* Scoped profiling zones. name must be a string literal (only its address is
+ * stored). Define EXPENGINE_DISABLE_PROFILING to compile them out. */
+#ifndef EXPENGINE_DISABLE_PROFILING
+#define EXPENGINE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define EXPENGINE_PROFILE_CONCAT(a, b) EXPENGINE_PROFILE_CONCAT_IMPL(a, b)
+#define EXPENGINE_PROFILE_ZONE(name)                                                \
+    experim::ProfileZone EXPENGINE_PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#define EXPENGINE_PROFILE_FUNCTION() EXPENGINE_PROFILE_ZONE(__func__)
+#else
+#define EXPENGINE_PROFILE_ZONE(name)
+#define EXPENGINE_PROFILE_FUNCTION()
+#endif
+
+namespace experim {
+
+struct ProfileZoneRecord {
+    const char* name;
+    Timer::Clock::time_point start;
+    Timer::Clock::time_point end;
+};
+
+/** Zones recorded by one thread. Only the owning thread writes, without locking :
+ * the records are published by the write index. Once full, the oldest records are
+ * overwritten. */
+class ThreadProfileBuffer {
+public:
+    ThreadProfileBuffer(uint32_t threadId, const std::string& threadName);
+
+    inline uint32_t threadId() const { return threadId_; };
+    inline const std::string& threadName() const { return threadName_; };
+
+    void record(const ProfileZoneRecord& zone);
+    /** Can be called from any thread. Appends to records the zones published since
+     * fromIndex that were not overwritten, and returns the next index to read. */
+    uint64_t read(uint64_t fromIndex, std::vector<ProfileZoneRecord>& records) const;
+    inline uint64_t writeIndex() const
+    {
+        return writeIndex_.load(std::memory_order_acquire);
+    };
+
+private:
+    friend class Profiler;
+
+    const uint32_t threadId_;
+    std::string threadName_;
+    std::vector<ProfileZoneRecord> zones_;
+    std::atomic<uint64_t> writeIndex_;
+    /* Index of the first zone of the current capture */
+    uint64_t captureStartIndex_;
+};
+
+/** Process-wide CPU profiler. Zones are only recorded between startCapture and
+ * stopCapture, which exports them as a Chrome trace-event JSON file (viewable in
+ * chrome://tracing or Perfetto). */
+class Profiler {
+public:
+    static Profiler& get();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    inline bool isCapturing() const
+    {
+        return capturing_.load(std::memory_order_relaxed);
+    };
+
+    void startCapture();
+    /** Writes the zones recorded since startCapture to filePath. Zones still open
+     * on other threads are not exported. */
+    void stopCapture(const std::string& filePath);
+
+    /** Names the calling thread in the exported traces. */
+    void setThreadName(const std::string& name);
+
+    void record(const ProfileZoneRecord& zone);
+
+private:
+    Profiler();
+
+    std::atomic<bool> capturing_;
+    Timer::Clock::time_point captureStart_;
+
+    /* Buffers are registered on the first zone of each thread, and live as long as
+     * the profiler */
+    std::mutex buffersMutex_;
+    std::vector<std::unique_ptr<ThreadProfileBuffer>> buffers_;
+
+    /* Logging */
+    std::shared_ptr<spdlog::logger> logger_;
+
+    ThreadProfileBuffer& threadBuffer();
+    ThreadProfileBuffer& registerThread(const std::string& threadName);
+};
+
+/** Records the zone from its construction to its destruction, if a capture is in
+ * progress when it is constructed. */
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name)
+        : name_(Profiler::get().isCapturing() ? name : nullptr)
+    {
+        if (name_)
+            start_ = Timer::Clock::now();
+    };
+    ~ProfileZone()
+    {
+        if (name_)
+            Profiler::get().record({name_, start_, Timer::Clock::now()});
+    };
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name_;
+    Timer::Clock::time_point start_;
+};
+
+} // namespace experim
@@ -0,0 +1,35 @@
+#include "HeadlessWindow.hpp"
+
+namespace experim {
+
+HeadlessWindow::HeadlessWindow(int width, int height)
+    : Window()
+    , width_(width)
+    , height_(height)
+{
+}
+
+void HeadlessWindow::setSize(int w, int h)
+{
+    width_ = w;
+    height_ = h;
+}
+
+std::pair<int, int> HeadlessWindow::getSize() const { return {width_, height_}; }
+
+std::pair<uint32_t, uint32_t> HeadlessWindow::getDrawableSizeInPixels() const
+{
+    return {(uint32_t) width_, (uint32_t) height_};
+}
+
+/* Nothing to title or to configure offscreen */
+std::shared_ptr<Window> HeadlessWindow::clone(
+    int width,
+    int height,
+    const std::string&,
+    uint32_t)
+{
+    return std::make_shared<HeadlessWindow>(width, height);
+}
+
+} // namespace experim
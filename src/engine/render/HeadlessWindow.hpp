@@ -0,0 +1,31 @@
+#pragma once
+
+#include <engine/render/Window.hpp>
+
+namespace experim {
+
+/** Window without any OS window, for headless rendering. It only holds a size, used
+ * as the drawable size by the offscreen RenderingContext. */
+class HeadlessWindow final : public Window {
+public:
+    HeadlessWindow(int width, int height);
+
+    void setSize(int w, int h) override;
+    std::pair<int, int> getSize() const override;
+    bool isFocused() const override { return true; };
+    bool isMinimized() const override { return false; };
+    bool isHeadless() const override { return true; };
+
+    std::pair<uint32_t, uint32_t> getDrawableSizeInPixels() const override;
+    std::shared_ptr<Window> clone(
+        int width,
+        int height,
+        const std::string& title,
+        uint32_t flags) override;
+
+private:
+    int width_;
+    int height_;
+};
+
+} // namespace experim
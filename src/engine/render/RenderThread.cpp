@@ -0,0 +1,79 @@
+#include "RenderThread.hpp"
+
+#include <engine/jobs/JobSystem.hpp>
+#include <engine/log/ExpengineLog.hpp>
+#include <engine/profiling/Profiler.hpp>
+
+namespace experim {
+
+RenderThread::RenderThread(JobSystem& jobSystem)
+    : jobSystem_(jobSystem)
+    , busy_(false)
+    , running_(true)
+    , logger_(spdlog::get(LOGGER_NAME))
+{
+    thread_ = std::thread(&RenderThread::threadLoop, this);
+    SPDLOG_LOGGER_INFO(logger_, "Render thread started");
+}
+
+RenderThread::~RenderThread()
+{
+    SPDLOG_LOGGER_DEBUG(logger_, "RenderThread destruction");
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this]() { return !busy_; });
+        running_ = false;
+    }
+    condition_.notify_all();
+    thread_.join();
+}
+
+void RenderThread::submit(RenderWork work)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this]() { return !busy_; });
+        pendingWork_ = std::move(work);
+        busy_ = true;
+    }
+    condition_.notify_all();
+}
+
+void RenderThread::waitIdle()
+{
+    EXPENGINE_PROFILE_ZONE("RenderThread::waitIdle");
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this]() { return !busy_; });
+}
+
+void RenderThread::threadLoop()
+{
+    Profiler::get().setThreadName("Render thread");
+    /* Records in its own per-thread slots, apart from the main thread */
+    jobSystem_.registerThread();
+    while (true)
+    {
+        RenderWork work;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return busy_ || !running_; });
+            if (!running_)
+                break;
+            work = std::move(pendingWork_);
+        }
+
+        {
+            EXPENGINE_PROFILE_ZONE("RenderThread::work");
+            work();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_ = false;
+        }
+        condition_.notify_all();
+    }
+    jobSystem_.unregisterThread();
+}
+
+} // namespace experim
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace spdlog {
+class logger;
+}
+
+namespace experim {
+
+class JobSystem;
+
+typedef std::function<void(void)> RenderWork;
+
+/** Dedicated thread recording and submitting one frame while the main thread
+ * prepares the next one. At most one frame is in flight on the thread. It is
+ * registered with jobSystem : it has its own JobSystem::threadIndex(). */
+class RenderThread {
+public:
+    RenderThread(JobSystem& jobSystem);
+    /** Waits for the frame in flight, then joins the thread. */
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /** Hands the work of a frame to the render thread. Waits for the previous frame
+     * to be done first. */
+    void submit(RenderWork work);
+    /** Blocks until the frame in flight, if any, is done. */
+    void waitIdle();
+
+private:
+    /* References */
+    JobSystem& jobSystem_;
+
+    /* Owned objects */
+    std::thread thread_;
+
+    /* Synchronization */
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    RenderWork pendingWork_;
+    bool busy_;
+    bool running_;
+
+    /* Logging */
+    std::shared_ptr<spdlog::logger> logger_;
+
+    void threadLoop();
+};
+
+} // namespace experim
@@ -12,6 +12,7 @@ class logger;
 namespace experim {
 
 struct EngineParameters;
+struct GraphicSettings;
 
 /** Abstract class used to manipulate the rendering system. */
 class Renderer : public IRendering {
@@ -21,6 +22,21 @@ public:
     virtual bool handleEvent(const SDL_Event& event) = 0;
     virtual void prepareFrame() = 0;
     virtual void renderFrame() = 0;
+    /** When enabled, frames are recorded and submitted on a dedicated thread while
+     * the next frame is simulated. */
+    virtual void setRenderThreadEnabled(bool enabled) = 0;
+    /** Headless mode only. Every frameInterval frames, the rendered image is
+     * written to directory. An interval of 0 disables it. */
+    virtual void setFrameReadback(
+        const std::string& directory,
+        uint32_t frameInterval)
+        = 0;
+    /** Frames recorded by the CPU while the GPU renders the previous ones, for the
+     * main window and the windows created afterwards. */
+    virtual void setFramesInFlight(uint32_t framesInFlight) = 0;
+    /** Stored in the EngineParameters. Rebuilds the main window swapchain when the
+     * presentation changes, the windows created afterwards use them too. */
+    virtual void setGraphicSettings(const GraphicSettings& graphicSettings) = 0;
 
     virtual void waitIdle() = 0;
     virtual std::shared_ptr<Window> getMainWindow() const = 0;
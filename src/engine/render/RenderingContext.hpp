@@ -13,6 +13,11 @@ class logger;
 
 namespace experim {
 
+/* Frames recorded by the CPU while the GPU renders the previous ones. 2 favors
+ * latency, 3 throughput. */
+const uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+const uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+
 enum class AttachmentsFlagBits : uint32_t
 {
     eColorAttachment = 1,
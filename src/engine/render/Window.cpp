@@ -22,11 +22,19 @@ Window::Window(int width, int height, const std::string& title, uint32_t flags)
     EXPENGINE_ASSERT(sdlWindow_, "Failed to create an SDL window");
 }
 
+Window::Window()
+    : sdlWindow_(nullptr)
+{
+}
+
 Window::~Window()
 {
-    SPDLOG_DEBUG("SDL Window destruction");
-    /* Calls SDL_Vulkan_UnloadLibrary if created with SDL_WINDOW_VULKAN */
-    SDL_DestroyWindow(sdlWindow_);
+    if (sdlWindow_)
+    {
+        SPDLOG_DEBUG("SDL Window destruction");
+        /* Calls SDL_Vulkan_UnloadLibrary if created with SDL_WINDOW_VULKAN */
+        SDL_DestroyWindow(sdlWindow_);
+    }
 }
 
 std::pair<uint32_t, uint32_t> Window::getDrawableSizeInPixels() const
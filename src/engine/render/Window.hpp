@@ -10,23 +10,25 @@ namespace experim {
 class Window {
 public:
     Window(int width, int height, const std::string& title, uint32_t flags);
-    ~Window();
+    virtual ~Window();
 
     void pollEvents();
     void waitEvents() const;
     void setOpacity(float opacity);
     void setBordered(bool bordered);
-    void setSize(int w, int h);
+    virtual void setSize(int w, int h);
     void setPosition(int x, int y);
     void setTitle(const char* title);
     void setFocus();
     std::pair<int, int> getPosition() const;
-    std::pair<int, int> getSize() const;
-    bool isFocused() const;
-    bool isMinimized() const;
+    virtual std::pair<int, int> getSize() const;
+    virtual bool isFocused() const;
+    virtual bool isMinimized() const;
     void hide();
     void show();
     uint32_t getWindowId() const;
+    /** True when there is no OS window behind this Window */
+    virtual bool isHeadless() const { return false; };
 
     /* Platform/OS specific */
     void* getPlatformHandle() const;
@@ -41,6 +43,9 @@ public:
         uint32_t flags);
 
 protected:
+    /** Used by windows without an SDL window */
+    Window();
+
     struct SDL_Window* sdlWindow_;
 };
 
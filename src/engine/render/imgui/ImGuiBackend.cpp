@@ -7,9 +7,11 @@
 #endif
 
 #include <engine/log/ExpengineLog.hpp>
+#include <engine/profiling/Profiler.hpp>
 #include <engine/render/RenderingContext.hpp>
 #include <engine/render/Window.hpp>
 #include <engine/render/imgui/ImGuiContextWrapper.hpp>
+#include <engine/render/imgui/ImGuiFramePacket.hpp>
 #include <engine/render/imgui/UIPlatformBackendSDL.hpp>
 #include <engine/render/imgui/UIRendererBackend.hpp>
 
@@ -47,7 +49,9 @@ ImguiBackend::ImguiBackend(
     /* Disable .ini file access. TODO Could add it to the virtual FS. */
     io.IniFilename = NULL;
 #else
-    io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+    /* No platform windows without a video subsystem */
+    if (!mainWindow->isHeadless())
+        io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
 #endif
 
     /* ------------------------------------------- */
@@ -109,12 +113,14 @@ bool ImguiBackend::handleEvent(const SDL_Event& event)
 
 void ImguiBackend::prepareFrame()
 {
+    EXPENGINE_PROFILE_ZONE("ImguiBackend::prepareFrame");
     platformBackend_->newFrame();
     ImGui::NewFrame();
 };
 
 void ImguiBackend::renderFrame()
 {
+    EXPENGINE_PROFILE_ZONE("ImguiBackend::renderFrame");
     /* Render everything inside ImGui */
     ImGui::Render();
 
@@ -126,7 +132,7 @@ void ImguiBackend::renderFrame()
         rendererData != nullptr,
         "Error, null RendererUserData for the main viewport");
 
-    renderingBackend_->renderViewport(mainViewport, rendererData);
+    renderingBackend_->renderViewport(mainViewport->DrawData, rendererData);
 
     /* Update and Render additional Platform Windows */
     ImGuiIO& io = ImGui::GetIO();
@@ -137,4 +143,102 @@ void ImguiBackend::renderFrame()
     }
 };
 
+void ImguiBackend::captureFrame(ImGuiFramePacket& packet)
+{
+    EXPENGINE_PROFILE_ZONE("ImguiBackend::captureFrame");
+    /* Render everything inside ImGui */
+    ImGui::Render();
+
+    packet.clear();
+    auto mainViewport = ImGui::GetMainViewport();
+    packet.addViewport(mainViewport->ID).snapshot.capture(*mainViewport->DrawData);
+
+    ImGuiIO& io = ImGui::GetIO();
+    if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+    {
+        /* Same filter as ImGui::RenderPlatformWindowsDefault. Viewports created by
+         * the next UpdatePlatformWindows are captured too. */
+        ImGuiPlatformIO& platformIO = ImGui::GetPlatformIO();
+        for (int i = 1; i < platformIO.Viewports.Size; i++)
+        {
+            ImGuiViewport* viewport = platformIO.Viewports[i];
+            if ((viewport->Flags & ImGuiViewportFlags_Minimized)
+                || viewport->DrawData == nullptr)
+                continue;
+            packet.addViewport(viewport->ID).snapshot.capture(*viewport->DrawData);
+        }
+    }
+};
+
+void ImguiBackend::updatePlatformWindows(ImGuiFramePacket& packet)
+{
+    EXPENGINE_PROFILE_ZONE("ImguiBackend::updatePlatformWindows");
+    ImGuiIO& io = ImGui::GetIO();
+    if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+        ImGui::UpdatePlatformWindows();
+
+    /* Bind the captured viewports to their renderer data. Drop the ones destroyed
+     * or minimized by the update. */
+    for (size_t i = 0; i < packet.viewportCount();)
+    {
+        auto& viewportPacket = packet.viewport(i);
+        ImGuiViewport* viewport = ImGui::FindViewportByID(viewportPacket.viewportId);
+        if (viewport && i == 0)
+        {
+            EXPENGINE_ASSERT(
+                viewport->RendererUserData != nullptr,
+                "Error, null RendererUserData for the main viewport");
+        }
+        if (viewport == nullptr || viewport->RendererUserData == nullptr
+            || (i > 0 && (viewport->Flags & ImGuiViewportFlags_Minimized)))
+        {
+            packet.removeViewport(i);
+            continue;
+        }
+        viewportPacket.rendererData
+            = (ImGuiViewportRendererData*) viewport->RendererUserData;
+        i++;
+    }
+};
+
+void ImguiBackend::renderFramePacket(ImGuiFramePacket& packet)
+{
+    EXPENGINE_PROFILE_ZONE("ImguiBackend::renderFramePacket");
+    if (packet.viewportCount() == 0)
+        return;
+
+    /* Main viewport, in the frame handled by the renderer */
+    auto& mainViewport = packet.viewport(0);
+    renderingBackend_->renderViewport(
+        mainViewport.snapshot.drawData(), mainViewport.rendererData);
+
+    /* Additional viewports own their frames, as in
+     * ImGui_ImplExpengine_RenderWindow */
+    for (size_t i = 1; i < packet.viewportCount(); i++)
+    {
+        auto& viewport = packet.viewport(i);
+        viewport.rendererData->renderingContext_->beginFrame();
+        renderingBackend_->renderViewport(
+            viewport.snapshot.drawData(), viewport.rendererData);
+        viewport.rendererData->renderingContext_->submitFrame();
+    }
+};
+
+void ImguiBackend::forEachPlatformRenderingContext(
+    const std::function<void(RenderingContext&)>& func)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    if (!(io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable))
+        return;
+
+    ImGuiPlatformIO& platformIO = ImGui::GetPlatformIO();
+    for (int i = 1; i < platformIO.Viewports.Size; i++)
+    {
+        auto rendererData
+            = (ImGuiViewportRendererData*) platformIO.Viewports[i]->RendererUserData;
+        if (rendererData)
+            func(*rendererData->renderingContext_);
+    }
+};
+
 } // namespace experim
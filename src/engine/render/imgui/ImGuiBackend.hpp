@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include <engine/render/Renderer.hpp>
@@ -16,6 +17,7 @@ class Window;
 class ImGuiContextWrapper;
 class UIPlatformBackendSDL;
 class UIRendererBackend;
+class ImGuiFramePacket;
 
 /** Custom back-end */
 class ImguiBackend {
@@ -31,6 +33,23 @@ public:
     void prepareFrame();
     void renderFrame();
 
+    /* Pipelined rendering, split between the main thread and the render thread */
+    /** Main thread. Ends the ImGui frame and copies the draw data of each viewport
+     * into packet. Can overlap with the rendering of the previous packet. */
+    void captureFrame(ImGuiFramePacket& packet);
+    /** Main thread, while no packet is being rendered : creates, resizes and
+     * destroys the platform windows, then binds the packet viewports to their
+     * renderer data. */
+    void updatePlatformWindows(ImGuiFramePacket& packet);
+    /** Render thread. Records the main viewport in the frame begun by the caller,
+     * then renders the additional viewports. Does not access the ImGui context. */
+    void renderFramePacket(ImGuiFramePacket& packet);
+
+    /** Main thread, while no frame is in flight. Calls func on the rendering
+     * context of each platform window, the main viewport excluded. */
+    void forEachPlatformRenderingContext(
+        const std::function<void(RenderingContext&)>& func);
+
 private:
     /* ImGui */
     std::shared_ptr<ImGuiContextWrapper> imguiContext_;
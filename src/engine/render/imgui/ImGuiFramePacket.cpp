@@ -0,0 +1,80 @@
+#include "ImGuiFramePacket.hpp"
+
+#include <cstring>
+
+namespace {
+
+template <typename T>
+void copyImVector(ImVector<T>& destination, const ImVector<T>& source)
+{
+    /* ImVector::operator= frees the destination memory, resize keeps its capacity */
+    destination.resize(source.Size);
+    if (source.Size > 0)
+        std::memcpy(destination.Data, source.Data, (size_t) source.Size * sizeof(T));
+}
+
+} // namespace
+
+namespace experim {
+
+void ImGuiDrawDataSnapshot::capture(const ImDrawData& source)
+{
+    const size_t listCount = static_cast<size_t>(source.CmdListsCount);
+    while (drawLists_.size() < listCount)
+    {
+        drawLists_.push_back(
+            std::make_unique<ImDrawList>(ImGui::GetDrawListSharedData()));
+    }
+    drawListHandles_.resize(listCount);
+
+    for (size_t n = 0; n < listCount; n++)
+    {
+        const ImDrawList* sourceList = source.CmdLists[n];
+        ImDrawList* list = drawLists_[n].get();
+        copyImVector(list->CmdBuffer, sourceList->CmdBuffer);
+        copyImVector(list->IdxBuffer, sourceList->IdxBuffer);
+        copyImVector(list->VtxBuffer, sourceList->VtxBuffer);
+        list->Flags = sourceList->Flags;
+        drawListHandles_[n] = list;
+    }
+
+    drawData_.Valid = source.Valid;
+    drawData_.CmdLists = drawListHandles_.data();
+    drawData_.CmdListsCount = source.CmdListsCount;
+    drawData_.TotalIdxCount = source.TotalIdxCount;
+    drawData_.TotalVtxCount = source.TotalVtxCount;
+    drawData_.DisplayPos = source.DisplayPos;
+    drawData_.DisplaySize = source.DisplaySize;
+    drawData_.FramebufferScale = source.FramebufferScale;
+    /* The viewport belongs to the ImGui context, not to be used by the renderer */
+    drawData_.OwnerViewport = nullptr;
+}
+
+ImGuiFramePacket::ImGuiFramePacket()
+    : viewportCount_(0)
+{
+}
+
+void ImGuiFramePacket::clear() { viewportCount_ = 0; }
+
+ImGuiViewportPacket& ImGuiFramePacket::addViewport(ImGuiID viewportId)
+{
+    if (viewportCount_ == viewports_.size())
+        viewports_.push_back(std::make_unique<ImGuiViewportPacket>());
+
+    auto& viewport = *viewports_[viewportCount_++];
+    viewport.viewportId = viewportId;
+    viewport.rendererData = nullptr;
+    return viewport;
+}
+
+void ImGuiFramePacket::removeViewport(size_t index)
+{
+    /* Move the removed packet past the end, to keep its buffers for later frames */
+    auto removed = std::move(viewports_[index]);
+    viewports_.erase(viewports_.begin() + index);
+    viewports_.push_back(std::move(removed));
+    viewportCount_--;
+}
+
+} // namespace experim
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <engine/render/imgui/lib/imgui.h>
+
+namespace experim {
+
+class ImGuiViewportRendererData;
+
+/** Copy of the draw data of one viewport. It owns its draw lists, so it stays valid
+ * after the next ImGui::NewFrame(). Draw lists and their buffers are reused from one
+ * capture to the next to avoid reallocations. */
+class ImGuiDrawDataSnapshot {
+public:
+    ImGuiDrawDataSnapshot() = default;
+    ImGuiDrawDataSnapshot(const ImGuiDrawDataSnapshot&) = delete;
+    ImGuiDrawDataSnapshot& operator=(const ImGuiDrawDataSnapshot&) = delete;
+
+    void capture(const ImDrawData& source);
+    inline ImDrawData* drawData() { return &drawData_; };
+
+private:
+    ImDrawData drawData_;
+    std::vector<std::unique_ptr<ImDrawList>> drawLists_;
+    /* Pointed to by drawData_.CmdLists */
+    std::vector<ImDrawList*> drawListHandles_;
+};
+
+struct ImGuiViewportPacket {
+    ImGuiID viewportId = 0;
+    /* Only resolved once ImGui::UpdatePlatformWindows() created the viewport objects
+     */
+    ImGuiViewportRendererData* rendererData = nullptr;
+    ImGuiDrawDataSnapshot snapshot;
+};
+
+/** UI data needed to render a frame, readable without the ImGui context : it is
+ * built on the main thread and rendered on the render thread. The main viewport is
+ * always the first one. */
+class ImGuiFramePacket {
+public:
+    ImGuiFramePacket();
+
+    void clear();
+    ImGuiViewportPacket& addViewport(ImGuiID viewportId);
+    /** Removes the viewport at index, without releasing its snapshot memory. */
+    void removeViewport(size_t index);
+
+    inline size_t viewportCount() const { return viewportCount_; };
+    inline ImGuiViewportPacket& viewport(size_t index)
+    {
+        return *viewports_[index];
+    };
+
+private:
+    /* Viewports past viewportCount_ are kept for reuse */
+    std::vector<std::unique_ptr<ImGuiViewportPacket>> viewports_;
+    size_t viewportCount_;
+};
+
+} // namespace experim
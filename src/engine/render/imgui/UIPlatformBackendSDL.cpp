@@ -111,9 +111,11 @@ UIPlatformBackendSDL::UIPlatformBackendSDL(
     mouseCursors_[ImGuiMouseCursor_NotAllowed]
         = SDL_CreateSystemCursor(SDL_SYSTEM_CURSOR_NO);
 
-    /* Check and store if we are on Wayland */
+    /* Check and store if we are on Wayland. There is no video driver when
+     * headless. */
+    const char* videoDriver = SDL_GetCurrentVideoDriver();
     mouseCanUseGlobalState_
-        = strncmp(SDL_GetCurrentVideoDriver(), "wayland", 7) != 0;
+        = videoDriver && strncmp(videoDriver, "wayland", 7) != 0;
 
     /* ------------------------------------------- */
     /* Setup main viewport/window                  */
@@ -75,19 +75,19 @@ UIRendererBackend::~UIRendererBackend()
 }
 
 void UIRendererBackend::renderViewport(
-    ImGuiViewport* viewport,
+    ImDrawData* drawData,
     ImGuiViewportRendererData* rendererData)
 {
     /* Avoid rendering when minimized, scale coordinates for retina displays (screen
      * coordinates != framebuffer coordinates) */
     uint32_t fbWidth = static_cast<uint32_t>(
-        viewport->DrawData->DisplaySize.x * viewport->DrawData->FramebufferScale.x);
+        drawData->DisplaySize.x * drawData->FramebufferScale.x);
     uint32_t fbHeight = static_cast<uint32_t>(
-        viewport->DrawData->DisplaySize.y * viewport->DrawData->FramebufferScale.y);
+        drawData->DisplaySize.y * drawData->FramebufferScale.y);
     if (fbWidth != 0 && fbHeight != 0)
     {
         /* Setup state and record draw commands */
-        uploadBuffersAndDraw(rendererData, viewport->DrawData, fbWidth, fbHeight);
+        uploadBuffersAndDraw(rendererData, drawData, fbWidth, fbHeight);
     }
 }
 
@@ -150,7 +150,7 @@ static void ImGui_ImplExpengine_RenderWindow(
     EXPENGINE_ASSERT(
         uiRenderingBackend != nullptr, "Error, null UI RenderingBackend");
 
-    uiRenderingBackend->renderViewport(viewport, rendererData);
+    uiRenderingBackend->renderViewport(viewport->DrawData, rendererData);
 
     rendererData->renderingContext_->submitFrame();
 }
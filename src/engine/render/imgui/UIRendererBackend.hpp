@@ -22,8 +22,10 @@ public:
 
     virtual void uploadFonts() = 0;
 
+    /** Does not access the ImGui context : drawData can be a snapshot rendered from
+     * another thread. */
     void renderViewport(
-        ImGuiViewport* viewport,
+        ImDrawData* drawData,
         ImGuiViewportRendererData* rendererData);
 
 protected:
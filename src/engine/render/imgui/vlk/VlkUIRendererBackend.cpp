@@ -1,32 +1,69 @@
 #include "VlkUIRendererBackend.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
+#include <vector>
 
+#include <engine/jobs/JobSystem.hpp>
 #include <engine/render/imgui/ImGuiViewportPlatformData.hpp>
 #include <engine/render/imgui/vlk/spirv/vlk_imgui_shaders_spirv.h>
 #include <engine/render/vlk/VlkDebug.hpp>
+#include <engine/render/vlk/VlkDeletionQueue.hpp>
 #include <engine/render/vlk/VlkDevice.hpp>
 #include <engine/render/vlk/VlkFrameCommandBuffer.hpp>
+#include <engine/render/vlk/VlkPipelineRegistry.hpp>
 #include <engine/render/vlk/VlkRenderer.hpp>
 #include <engine/render/vlk/VlkRenderingContext.hpp>
+#include <engine/render/vlk/VlkTextureTable.hpp>
+#include <engine/render/vlk/resources/VlkBuffer.hpp>
 #include <engine/render/vlk/resources/VlkTexture.hpp>
 
-/**
- * TODO : Backend not yet handling custom texture rendering.
- */
-
 namespace {
 
 const std::string RENDERER_BACKEND_NAME = "ExperimEngine_Vulkan_Renderer";
 
+/* Geometry buffers grow by GEOMETRY_GROWTH_FACTOR, and only shrink back after
+ * GEOMETRY_SHRINK_DELAY consecutive uses below a quarter of their size */
+const vk::DeviceSize MIN_GEOMETRY_BUFFER_SIZE = 64 * 1024;
+const double GEOMETRY_GROWTH_FACTOR = 1.5;
+const uint32_t GEOMETRY_SHRINK_DELAY = 300;
+
+/* TODO Set once __glsl_vlk_shader_bindless_frag_spv is regenerated by
+ * glslangValidator from shaders/glsl_shader_bindless.frag : the current binary was
+ * assembled by hand and never validated, so the fallback table is used even on
+ * devices with descriptor indexing. */
+const bool USE_BINDLESS_SHADER = false;
+
+/* Above this count, the draw lists of a viewport are recorded by several jobs,
+ * DRAW_LISTS_PER_JOB each */
+const uint32_t DRAW_LISTS_PER_JOB = 8;
+
+/* After the vertex stage scale and translation */
+const uint32_t TEXTURE_PUSH_CONSTANT_OFFSET = sizeof(float) * 4;
+
+/* Texture ids are offset by one : a null ImTextureID is never a valid texture */
+ImTextureID toTextureId(experim::vlk::TextureTable::Handle handle)
+{
+    return (ImTextureID)(intptr_t)(handle + 1);
+}
+experim::vlk::TextureTable::Handle toTextureHandle(ImTextureID textureId)
+{
+    return static_cast<experim::vlk::TextureTable::Handle>((intptr_t) textureId - 1);
+}
+
 } // namespace
 
 namespace experim {
 namespace vlk {
 
+/** Vertices then indices, in a single persistently mapped buffer */
 struct FrameRenderBuffers {
-    std::unique_ptr<Buffer> vertexBuffer = nullptr;
-    std::unique_ptr<Buffer> indexBuffer = nullptr;
+    std::unique_ptr<Buffer> geometryBuffer = nullptr;
+    vk::DeviceSize indexOffset = 0;
+    uint32_t underusedCount = 0;
+    /* Recorded by the draw jobs. Keeps its capacity across frames. */
+    std::vector<vk::CommandBuffer> secondaryCommandBuffers;
 };
 
 /** The Vulkan-specific derived class  stored in the void*
@@ -39,15 +76,22 @@ public:
         /* This will be stored by ImGui in a (void *).
          * Will be cleaned by ImGui_ImplExpengine_DestroyWindow */
         return new VkImGuiViewportRendererData(
-            renderingContext, graphicsPipelineInfo_);
+            renderingContext,
+            pipelineRegistry_,
+            deletionQueue_,
+            graphicsPipelineInfo_);
     };
 
     /** Constructor used publicly only once for the main viewport. Other viewports
      * will clone the main one. */
     VkImGuiViewportRendererData(
         std::shared_ptr<RenderingContext> renderingContext,
-        vk::GraphicsPipelineCreateInfo& graphicsPipelineInfo)
+        PipelineRegistry& pipelineRegistry,
+        DeletionQueue& deletionQueue,
+        const vk::GraphicsPipelineCreateInfo& graphicsPipelineInfo)
         : ImGuiViewportRendererData(renderingContext)
+        , pipelineRegistry_(pipelineRegistry)
+        , deletionQueue_(deletionQueue)
         , graphicsPipelineInfo_(graphicsPipelineInfo)
     {
         /* Initialize viewport objects */
@@ -57,12 +101,7 @@ public:
     ~VkImGuiViewportRendererData()
     {
         SPDLOG_DEBUG("VkImGuiViewportRendererData destruction");
-
-        /* Wait for the RenderingContext to be idle, then we can delete all used
-         * resources */
-        auto vkRenderingContext
-            = std::dynamic_pointer_cast<VulkanRenderingContext>(renderingContext_);
-        vkRenderingContext->waitIdle();
+        releaseRenderBuffers();
     }
 
     FrameRenderBuffers& requestFrameRenderBuffers()
@@ -72,14 +111,21 @@ public:
         return frame;
     }
 
-    const vk::Pipeline pipeline() { return *uiGraphicsPipeline_; }
+    const vk::Pipeline pipeline() { return uiGraphicsPipeline_; }
 
 protected:
+    /* References */
+    PipelineRegistry& pipelineRegistry_;
+    DeletionQueue& deletionQueue_;
+
     /* Owned objects */
-    vk::UniquePipeline uiGraphicsPipeline_;
     std::vector<FrameRenderBuffers> renderBuffers_;
     uint32_t frameIndex_;
 
+    /* Handles */
+    /* Owned by the registry, shared with the compatible viewports */
+    vk::Pipeline uiGraphicsPipeline_;
+
     /* Configuration */
     /* Hold a copy since it will be modified. */
     vk::GraphicsPipelineCreateInfo graphicsPipelineInfo_;
@@ -89,14 +135,30 @@ protected:
         auto vkRenderingContext
             = std::dynamic_pointer_cast<VulkanRenderingContext>(renderingContext_);
 
-        /* (Re)build Graphics pipeline */
-        uiGraphicsPipeline_
-            = vkRenderingContext->createGraphicsPipeline(graphicsPipelineInfo_);
+        /* A resize keeps the render pass compatible : the pipeline is found in the
+         * registry, without any compilation */
+        graphicsPipelineInfo_.renderPass = vkRenderingContext->renderPass();
+        uiGraphicsPipeline_ = pipelineRegistry_.graphicsPipeline(
+            graphicsPipelineInfo_, vkRenderingContext->renderPassCompatibility());
 
-        /* Reset buffers container */
+        releaseRenderBuffers();
         frameIndex_ = 0;
-        renderBuffers_.resize(vkRenderingContext->imageCount());
+        renderBuffers_ = std::vector<FrameRenderBuffers>(
+            vkRenderingContext->framesInFlight());
     };
+
+    /* The frames of the context may still read the buffers : no wait, they are
+     * destroyed once complete */
+    void releaseRenderBuffers()
+    {
+        if (renderBuffers_.empty())
+            return;
+        auto vkRenderingContext
+            = std::dynamic_pointer_cast<VulkanRenderingContext>(renderingContext_);
+        deletionQueue_.release(
+            std::move(renderBuffers_), vkRenderingContext->submittedValue());
+        renderBuffers_.clear();
+    }
 };
 
 VulkanUIRendererBackend::VulkanUIRendererBackend(
@@ -106,6 +168,7 @@ VulkanUIRendererBackend::VulkanUIRendererBackend(
     : UIRendererBackend(imguiContext, RENDERER_BACKEND_NAME)
     , renderer_(dynamic_cast<const VulkanRenderer&>(renderer))
     , device_(renderer_.getDevice())
+    , pipelineRegistry_(std::make_unique<PipelineRegistry>(device_))
 {
     /* ------------------------------------------- */
     /* Create device objects                       */
@@ -125,26 +188,8 @@ VulkanUIRendererBackend::VulkanUIRendererBackend(
     EXPENGINE_VK_ASSERT(samplerResult.result, "Failed to create font sampler");
     fontSampler_ = std::move(samplerResult.value);
 
-    /* Descriptor set layout */
-    vk::DescriptorSetLayoutBinding binding[1]
-        = {{.descriptorType = vk::DescriptorType::eCombinedImageSampler,
-            .descriptorCount = 1,
-            .stageFlags = vk::ShaderStageFlagBits::eFragment,
-            .pImmutableSamplers = &fontSampler_.get()}};
-    auto descSetLayoutResult
-        = device_.deviceHandle().createDescriptorSetLayoutUnique(
-            {.bindingCount = 1, .pBindings = binding});
-    EXPENGINE_VK_ASSERT(
-        descSetLayoutResult.result, "Failed to create descriptor set layout");
-    descriptorSetLayout_ = std::move(descSetLayoutResult.value);
-
-    /* Descriptor set */
-    auto descriptorResult = device_.deviceHandle().allocateDescriptorSets(
-        {.descriptorPool = device_.descriptorPool(),
-         .descriptorSetCount = 1,
-         .pSetLayouts = &descriptorSetLayout_.get()});
-    EXPENGINE_VK_ASSERT(descriptorResult.result, "Failed to create descriptor set");
-    descriptorSet_ = descriptorResult.value.front();
+    /* Textures, bindless if the device and the shader allow it */
+    textureTable_ = std::make_unique<TextureTable>(device_, USE_BINDLESS_SHADER);
 
     /* Create ImGui shaders modules */
     auto vertShaderResult = device_.deviceHandle().createShaderModuleUnique(
@@ -154,9 +199,14 @@ VulkanUIRendererBackend::VulkanUIRendererBackend(
         vertShaderResult.result, "Failed to create the ImGui vertex shader");
     vertShader_ = std::move(vertShaderResult.value);
 
-    auto fragShaderResult = device_.deviceHandle().createShaderModuleUnique(
-        {.codeSize = sizeof(__glsl_vlk_shader_frag_spv),
-         .pCode = (uint32_t*) __glsl_vlk_shader_frag_spv});
+    /* The bindless shader samples the texture indexed by a push constant */
+    auto fragShaderResult = textureTable_->isBindless()
+        ? device_.deviceHandle().createShaderModuleUnique(
+            {.codeSize = sizeof(__glsl_vlk_shader_bindless_frag_spv),
+             .pCode = (uint32_t*) __glsl_vlk_shader_bindless_frag_spv})
+        : device_.deviceHandle().createShaderModuleUnique(
+            {.codeSize = sizeof(__glsl_vlk_shader_frag_spv),
+             .pCode = (uint32_t*) __glsl_vlk_shader_frag_spv});
     EXPENGINE_VK_ASSERT(
         fragShaderResult.result, "Failed to create the ImGui fragment shader");
     fragShader_ = std::move(fragShaderResult.value);
@@ -172,14 +222,18 @@ VulkanUIRendererBackend::VulkanUIRendererBackend(
         .pName = "main"};
 
     /* Pipeline layout */
-    vk::PushConstantRange pushConstants[1]
+    vk::PushConstantRange pushConstants[2]
         = {{.stageFlags = vk::ShaderStageFlagBits::eVertex,
             .offset = 0,
-            .size = sizeof(float) * 4}};
+            .size = sizeof(float) * 4},
+           {.stageFlags = vk::ShaderStageFlagBits::eFragment,
+            .offset = TEXTURE_PUSH_CONSTANT_OFFSET,
+            .size = sizeof(TextureTable::Handle)}};
+    const vk::DescriptorSetLayout setLayout = textureTable_->layout();
     auto pipelineLayoutResult = device_.deviceHandle().createPipelineLayoutUnique(
         {.setLayoutCount = 1,
-         .pSetLayouts = &descriptorSetLayout_.get(),
-         .pushConstantRangeCount = 1,
+         .pSetLayouts = &setLayout,
+         .pushConstantRangeCount = textureTable_->isBindless() ? 2u : 1u,
          .pPushConstantRanges = pushConstants});
     EXPENGINE_VK_ASSERT(
         pipelineLayoutResult.result, "Failed to create pipeline layout");
@@ -268,12 +322,18 @@ VulkanUIRendererBackend::VulkanUIRendererBackend(
      * enabled. Else cleaned by RendererBackend */
     ImGuiViewport* mainViewport = ImGui::GetMainViewport();
     mainViewport->RendererUserData = new VkImGuiViewportRendererData(
-        mainRenderingContext, graphicsPipelineInfo_);
+        mainRenderingContext,
+        *pipelineRegistry_,
+        device_.deletionQueue(),
+        graphicsPipelineInfo_);
 }
 
 VulkanUIRendererBackend::~VulkanUIRendererBackend()
 {
     SPDLOG_LOGGER_DEBUG(logger_, "VulkanUIRendererBackend destruction");
+    /* The main viewport data is only destroyed by the base class : its frames may
+     * still use the registry pipelines */
+    device_.waitIdle();
 }
 
 void VulkanUIRendererBackend::uploadFonts()
@@ -295,16 +355,21 @@ void VulkanUIRendererBackend::uploadFonts()
         height,
         fontSampler_.get());
 
-    /* Store font texture identifier */
-    io.Fonts->TexID = (ImTextureID)(intptr_t)(VkImage) fontTexture_->imageHandle();
+    /* Store font texture identifier. The handle is kept so that the render thread
+     * never reads the ImGui IO. */
+    fontTextureHandle_
+        = textureTable_->registerTexture(fontTexture_->descriptorInfo());
+    io.Fonts->TexID = toTextureId(fontTextureHandle_);
+}
+
+ImTextureID VulkanUIRendererBackend::registerTexture(const VlkTexture& texture)
+{
+    return toTextureId(textureTable_->registerTexture(texture.descriptorInfo()));
+}
 
-    /* Update the descriptor set with the image info */
-    vk::WriteDescriptorSet writeDesc {
-        .dstSet = descriptorSet_,
-        .descriptorCount = 1,
-        .descriptorType = vk::DescriptorType::eCombinedImageSampler,
-        .pImageInfo = &fontTexture_->descriptorInfo()};
-    device_.deviceHandle().updateDescriptorSets(writeDesc, nullptr);
+void VulkanUIRendererBackend::unregisterTexture(ImTextureID textureId)
+{
+    textureTable_->unregisterTexture(toTextureHandle(textureId));
 }
 
 void VulkanUIRendererBackend::uploadBuffersAndDraw(
@@ -325,50 +390,98 @@ void VulkanUIRendererBackend::uploadBuffersAndDraw(
 
     if (drawData->TotalVtxCount > 0)
     {
-        size_t vertexSize = drawData->TotalVtxCount * sizeof(ImDrawVert);
-        size_t indexSize = drawData->TotalIdxCount * sizeof(ImDrawIdx);
-
-        if (frame.vertexBuffer == nullptr || frame.vertexBuffer->size() < vertexSize)
-        {
-            SPDLOG_LOGGER_DEBUG(logger_, "Resizing vertex buffer to {}", vertexSize);
-            frame.vertexBuffer = device_.allocator().createVertexBuffer(vertexSize);
-        }
-        if (frame.indexBuffer == nullptr || frame.indexBuffer->size() < indexSize)
-        {
-            SPDLOG_LOGGER_DEBUG(logger_, "Resizing index buffer to {}", indexSize);
-            frame.indexBuffer = device_.allocator().createIndexBuffer(indexSize);
-        }
-
-        frame.vertexBuffer->assertMap();
-        frame.indexBuffer->assertMap();
-
+        const vk::DeviceSize vertexSize
+            = drawData->TotalVtxCount * sizeof(ImDrawVert);
+        const vk::DeviceSize indexSize = drawData->TotalIdxCount * sizeof(ImDrawIdx);
+        /* Index offset must be a multiple of the index size */
+        const vk::DeviceSize indexAlignment = sizeof(uint32_t);
+        const vk::DeviceSize indexOffset
+            = (vertexSize + indexAlignment - 1) / indexAlignment * indexAlignment;
+        const vk::DeviceSize requiredSize = indexOffset + indexSize;
+        reserveGeometryBuffer(
+            frame, requiredSize, vlkRenderingContext.submittedValue());
+        frame.indexOffset = indexOffset;
+
+        auto mapped = static_cast<uint8_t*>(frame.geometryBuffer->mappedData());
+        auto vertexDst = mapped;
+        auto indexDst = mapped + indexOffset;
         for (int n = 0; n < drawData->CmdListsCount; n++)
         {
             const ImDrawList* cmdList = drawData->CmdLists[n];
-            frame.vertexBuffer->copyData(
-                cmdList->VtxBuffer.Data,
-                cmdList->VtxBuffer.Size * sizeof(ImDrawVert));
-            frame.indexBuffer->copyData(
-                cmdList->IdxBuffer.Data,
-                cmdList->IdxBuffer.Size * sizeof(ImDrawIdx));
+            const size_t cmdVertexSize
+                = cmdList->VtxBuffer.Size * sizeof(ImDrawVert);
+            const size_t cmdIndexSize = cmdList->IdxBuffer.Size * sizeof(ImDrawIdx);
+            memcpy(vertexDst, cmdList->VtxBuffer.Data, cmdVertexSize);
+            memcpy(indexDst, cmdList->IdxBuffer.Data, cmdIndexSize);
+            vertexDst += cmdVertexSize;
+            indexDst += cmdIndexSize;
         }
-        /* TODO Could flush both allocation at once */
-        frame.vertexBuffer->assertFlush();
-        frame.indexBuffer->assertFlush();
-
-        frame.vertexBuffer->unmap();
-        frame.indexBuffer->unmap();
+        /* A single flush for both ranges */
+        frame.geometryBuffer->assertFlush(requiredSize, 0);
     }
 
+    /* ------------------
+     * Draw commands
+     *------------------ */
+
+    const vk::Pipeline pipeline = vlkViewportData->pipeline();
+    const uint32_t listCount = static_cast<uint32_t>(drawData->CmdListsCount);
     auto& cmdBuffer = vlkRenderingContext.requestCommandBuffer();
-    cmdBuffer.beginRenderPass();
+    if (listCount <= DRAW_LISTS_PER_JOB)
+    {
+        cmdBuffer.beginRenderPass();
+        recordDrawLists(
+            cmdBuffer, pipeline, frame, drawData, fbWidth, fbHeight, 0, listCount);
+    }
+    else
+    {
+        /* Each job records its draw lists in a secondary command buffer, from the
+         * command pool of its thread. They are executed in the draw lists order. */
+        frame.secondaryCommandBuffers.resize(
+            (listCount + DRAW_LISTS_PER_JOB - 1) / DRAW_LISTS_PER_JOB);
+        renderer_.jobs().parallelFor(
+            listCount, DRAW_LISTS_PER_JOB, [&](uint32_t begin, uint32_t end) {
+                auto& secondary
+                    = vlkRenderingContext.requestSecondaryCommandBuffer();
+                recordDrawLists(
+                    secondary,
+                    pipeline,
+                    frame,
+                    drawData,
+                    fbWidth,
+                    fbHeight,
+                    begin,
+                    end);
+                secondary.end();
+                frame.secondaryCommandBuffers[begin / DRAW_LISTS_PER_JOB]
+                    = secondary.getHandle();
+            });
+
+        cmdBuffer.beginRenderPass(vk::SubpassContents::eSecondaryCommandBuffers);
+        cmdBuffer.executeCommands(frame.secondaryCommandBuffers);
+    }
+
+    /* End RenderPass */
+    cmdBuffer.endRenderPass();
+    cmdBuffer.end();
+}
 
+void VulkanUIRendererBackend::recordDrawLists(
+    FrameCommandBuffer& cmdBuffer,
+    const vk::Pipeline pipeline,
+    FrameRenderBuffers& frame,
+    ImDrawData* drawData,
+    uint32_t fbWidth,
+    uint32_t fbHeight,
+    uint32_t firstList,
+    uint32_t endList) const
+{
     /* ------------------
      * Setup render state
      *------------------ */
 
-    setupRenderState(
-        cmdBuffer, vlkViewportData->pipeline(), frame, drawData, fbWidth, fbHeight);
+    setupRenderState(cmdBuffer, pipeline, frame, drawData, fbWidth, fbHeight);
+    ImTextureID boundTexture = nullptr;
 
     /* ------------------
      * Draw commands
@@ -383,7 +496,12 @@ void VulkanUIRendererBackend::uploadBuffersAndDraw(
      * them */
     uint32_t globalVertexOffset = 0;
     uint32_t globalIndexOffset = 0;
-    for (uint32_t n = 0; n < (uint32_t) drawData->CmdListsCount; n++)
+    for (uint32_t n = 0; n < firstList; n++)
+    {
+        globalVertexOffset += drawData->CmdLists[n]->VtxBuffer.Size;
+        globalIndexOffset += drawData->CmdLists[n]->IdxBuffer.Size;
+    }
+    for (uint32_t n = firstList; n < endList; n++)
     {
         const ImDrawList* cmdList = drawData->CmdLists[n];
         for (uint32_t cmd_i = 0; cmd_i < (uint32_t) cmdList->CmdBuffer.Size; cmd_i++)
@@ -395,13 +513,11 @@ void VulkanUIRendererBackend::uploadBuffersAndDraw(
                  * (ImDrawCallback_ResetRenderState is a special callback value used
                  * by the user to request the renderer to reset render state.) */
                 if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
+                {
                     setupRenderState(
-                        cmdBuffer,
-                        vlkViewportData->pipeline(),
-                        frame,
-                        drawData,
-                        fbWidth,
-                        fbHeight);
+                        cmdBuffer, pipeline, frame, drawData, fbWidth, fbHeight);
+                    boundTexture = nullptr;
+                }
                 else
                     pcmd->UserCallback(cmdList, pcmd);
             }
@@ -432,6 +548,13 @@ void VulkanUIRendererBackend::uploadBuffersAndDraw(
                         .height = (uint32_t)(clipRect.w - clipRect.y)};
                     cmdBuffer.getHandle().setScissor(0, scissor);
 
+                    /* Bindless : a push constant. Else a descriptor set bind. */
+                    if (pcmd->TextureId != boundTexture)
+                    {
+                        bindTexture(cmdBuffer, pcmd->TextureId);
+                        boundTexture = pcmd->TextureId;
+                    }
+
                     /* Draw */
                     cmdBuffer.drawIndexed(
                         pcmd->ElemCount,
@@ -444,9 +567,60 @@ void VulkanUIRendererBackend::uploadBuffersAndDraw(
         globalIndexOffset += cmdList->IdxBuffer.Size;
     }
 
-    /* End RenderPass */
-    cmdBuffer.endRenderPass();
-    cmdBuffer.end();
+}
+
+void VulkanUIRendererBackend::reserveGeometryBuffer(
+    FrameRenderBuffers& frame,
+    vk::DeviceSize requiredSize,
+    uint64_t lastUseValue) const
+{
+    const vk::DeviceSize currentSize
+        = frame.geometryBuffer ? frame.geometryBuffer->size() : 0;
+
+    if (requiredSize <= currentSize)
+    {
+        /* Hysteresis : a large panel closed for a short time does not trigger a
+         * reallocation */
+        if (currentSize > MIN_GEOMETRY_BUFFER_SIZE && requiredSize < currentSize / 4)
+            frame.underusedCount++;
+        else
+            frame.underusedCount = 0;
+        if (frame.underusedCount < GEOMETRY_SHRINK_DELAY)
+            return;
+    }
+
+    const auto newSize = std::max(
+        MIN_GEOMETRY_BUFFER_SIZE,
+        static_cast<vk::DeviceSize>(requiredSize * GEOMETRY_GROWTH_FACTOR));
+    SPDLOG_LOGGER_DEBUG(
+        logger_, "Resizing UI geometry buffer from {} to {}", currentSize, newSize);
+
+    if (frame.geometryBuffer)
+    {
+        device_.deletionQueue().release(
+            std::move(frame.geometryBuffer), lastUseValue);
+    }
+    frame.geometryBuffer = device_.allocator().createGeometryBuffer(newSize);
+    frame.geometryBuffer->assertMap();
+    frame.underusedCount = 0;
+}
+
+void VulkanUIRendererBackend::bindTexture(
+    FrameCommandBuffer& cmdBuffer,
+    ImTextureID textureId) const
+{
+    const auto handle = toTextureHandle(textureId);
+    if (textureTable_->isBindless())
+    {
+        cmdBuffer.pushConstants<TextureTable::Handle>(
+            vk::ShaderStageFlagBits::eFragment,
+            TEXTURE_PUSH_CONSTANT_OFFSET,
+            handle);
+    }
+    else
+    {
+        cmdBuffer.bindDescriptorSet(textureTable_->descriptorSet(handle));
+    }
 }
 
 void VulkanUIRendererBackend::setupRenderState(
@@ -457,16 +631,21 @@ void VulkanUIRendererBackend::setupRenderState(
     uint32_t fbWidth,
     uint32_t fbHeight) const
 {
-    /* Bind objects to command buffer */
-    cmdBuffer.bind(pipeline, *pipelineLayout_, descriptorSet_);
+    /* Bind objects to command buffer. When bindless, this is the only descriptor
+     * set bind. */
+    cmdBuffer.bind(
+        pipeline,
+        *pipelineLayout_,
+        textureTable_->descriptorSet(fontTextureHandle_));
 
     if (drawData->TotalVtxCount > 0)
     {
         cmdBuffer.bindBuffers(
-            *frame.vertexBuffer,
-            *frame.indexBuffer,
-            sizeof(ImDrawIdx) == 2 ? vk::IndexType::eUint16
-                                   : vk::IndexType::eUint32);
+            *frame.geometryBuffer,
+            *frame.geometryBuffer,
+            sizeof(ImDrawIdx) == 2 ? vk::IndexType::eUint16 : vk::IndexType::eUint32,
+            0,
+            frame.indexOffset);
     }
 
     /* Viewport */
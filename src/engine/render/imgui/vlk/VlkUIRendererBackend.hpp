@@ -13,13 +13,14 @@ class Device;
 class VulkanRenderer;
 class VlkTexture;
 class FrameCommandBuffer;
+class PipelineRegistry;
+class TextureTable;
 struct FrameRenderBuffers;
 
 /* Shared device objects at backend level : */
 /* -> Font Texture (Image + ImageView + Memory) */
 /* -> Sampler (font) */
-/* -> Descriptor set layout */
-/* -> Descriptor set */
+/* -> Texture table (descriptor set layout and sets) */
 /* -> Pipeline layout
 /* -> Shader modules and stage info */
 
@@ -34,6 +35,12 @@ public:
 
     void uploadFonts() override;
 
+    /** Returns the id to draw texture with ImGui::Image. Its descriptor info must
+     * hold a sampler. */
+    ImTextureID registerTexture(const VlkTexture& texture);
+    /** No pending frame may still draw the texture */
+    void unregisterTexture(ImTextureID textureId);
+
     /** Called by ImGui callbacks for secondary viewports.
      * TODO make it fully shared between rendering backends */
     void uploadBuffersAndDraw(
@@ -49,14 +56,17 @@ private:
 
     /* Vulkan objects shared by all the RenderingContext(s) */
     std::unique_ptr<VlkTexture> fontTexture_;
-    vk::UniqueDescriptorSetLayout descriptorSetLayout_;
-    /* Descriptor set is not unique since the pool owns it
-     * (VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT not used)  */
-    vk::DescriptorSet descriptorSet_;
+    /* ImTextureID are handles of this table, offset by one */
+    std::unique_ptr<TextureTable> textureTable_;
+    /* Handle of fontTexture_ in the table, bound by setupRenderState */
+    uint32_t fontTextureHandle_ = 0;
     vk::UniqueSampler fontSampler_;
 
-    /* Graphic pipeline objects. Used to create the ImGui Graphics Pipeline
-     * for each RenderingContext. */
+    /* ImGui graphics pipelines, one per render pass compatibility */
+    std::unique_ptr<PipelineRegistry> pipelineRegistry_;
+
+    /* Graphic pipeline objects. Used to create the ImGui Graphics Pipelines
+     * registered by the RenderingContext(s). */
     vk::UniquePipelineLayout pipelineLayout_;
     vk::UniqueShaderModule vertShader_;
     vk::UniqueShaderModule fragShader_;
@@ -76,9 +86,30 @@ private:
     /* All the above members are used to fill this
      * GraphicsPipelineCreateInfo. The only missing info in order to create
      * a Pipeline is a RenderPass which is provided by each
-     * RenderingContext. */
+     * RenderingContext. Viewports with compatible render passes share the
+     * same pipeline. */
     vk::GraphicsPipelineCreateInfo graphicsPipelineInfo_;
 
+    /** Grows or shrinks the buffer of frame to hold requiredSize bytes. The
+     * replaced buffer is released once the timeline reaches lastUseValue. */
+    void reserveGeometryBuffer(
+        FrameRenderBuffers& frame,
+        vk::DeviceSize requiredSize,
+        uint64_t lastUseValue) const;
+    /** Records the draw lists [firstList, endList) of drawData, render state
+     * included, inside the render pass begun for cmdBuffer. Called concurrently by
+     * the draw jobs : ImGui user callbacks may run on worker threads. */
+    void recordDrawLists(
+        FrameCommandBuffer& cmdBuffer,
+        const vk::Pipeline pipeline,
+        FrameRenderBuffers& frame,
+        ImDrawData* drawData,
+        uint32_t fbWidth,
+        uint32_t fbHeight,
+        uint32_t firstList,
+        uint32_t endList) const;
+    /** Makes the next draws sample the texture */
+    void bindTexture(FrameCommandBuffer& cmdBuffer, ImTextureID textureId) const;
     void setupRenderState(
         FrameCommandBuffer& cmdBuffer,
         const vk::Pipeline pipeline,
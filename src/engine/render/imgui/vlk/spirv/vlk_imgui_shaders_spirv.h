@@ -125,4 +125,60 @@ const uint32_t __glsl_vlk_shader_frag_spv[]
        0x00000012, 0x0000001c, 0x0003003e, 0x00000009, 0x0000001d, 0x000100fd,
        0x00010038};
 
+// glsl_shader_bindless.frag, for devices with descriptor indexing. Unlike the
+// shaders above, this binary was assembled by hand and not produced by a compiler :
+// it has no debug names, and it was not validated with spirv-val. It is not used
+// until it is regenerated from ../shaders/glsl_shader_bindless.frag with:
+// # glslangValidator -V -x -o glsl_shader_bindless.frag.u32 \
+//   glsl_shader_bindless.frag
+/*
+#version 450 core
+layout(location = 0) out vec4 fColor;
+layout(set=0, binding=0) uniform sampler2D sTextures[1024];
+layout(push_constant) uniform uPushConstant { layout(offset = 16) uint uTexture;
+} pc;
+layout(location = 0) in struct { vec4 Color; vec2 UV; } In;
+void main()
+{
+        fColor = In.Color * texture(sTextures[pc.uTexture], In.UV.st);
+}
+*/
+const uint32_t __glsl_vlk_shader_bindless_frag_spv[]
+    = {0x07230203, 0x00010000, 0x00000000, 0x00000028, 0x00000000, 0x00020011,
+       0x00000001, 0x00020011, 0x0000001d, 0x0003000e, 0x00000000, 0x00000001,
+       0x0007000f, 0x00000004, 0x00000001, 0x6e69616d, 0x00000000, 0x00000002,
+       0x00000003, 0x00030010, 0x00000001, 0x00000007, 0x00030003, 0x00000002,
+       0x000001c2, 0x00040047, 0x00000002, 0x0000001e, 0x00000000, 0x00040047,
+       0x00000003, 0x0000001e, 0x00000000, 0x00040047, 0x00000004, 0x00000022,
+       0x00000000, 0x00040047, 0x00000004, 0x00000021, 0x00000000, 0x00050048,
+       0x00000019, 0x00000000, 0x00000023, 0x00000010, 0x00030047, 0x00000019,
+       0x00000002, 0x00020013, 0x00000006, 0x00030021, 0x00000007, 0x00000006,
+       0x00030016, 0x00000008, 0x00000020, 0x00040017, 0x00000009, 0x00000008,
+       0x00000004, 0x00040020, 0x0000000a, 0x00000003, 0x00000009, 0x0004003b,
+       0x0000000a, 0x00000002, 0x00000003, 0x00040017, 0x0000000b, 0x00000008,
+       0x00000002, 0x0004001e, 0x0000000c, 0x00000009, 0x0000000b, 0x00040020,
+       0x0000000d, 0x00000001, 0x0000000c, 0x0004003b, 0x0000000d, 0x00000003,
+       0x00000001, 0x00040015, 0x0000000e, 0x00000020, 0x00000001, 0x0004002b,
+       0x0000000e, 0x0000000f, 0x00000000, 0x0004002b, 0x0000000e, 0x00000010,
+       0x00000001, 0x00040020, 0x00000011, 0x00000001, 0x00000009, 0x00040020,
+       0x00000012, 0x00000001, 0x0000000b, 0x00090019, 0x00000013, 0x00000008,
+       0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000001, 0x00000000,
+       0x0003001b, 0x00000014, 0x00000013, 0x00040015, 0x00000015, 0x00000020,
+       0x00000000, 0x0004002b, 0x00000015, 0x00000016, 0x00000400, 0x0004001c,
+       0x00000017, 0x00000014, 0x00000016, 0x00040020, 0x00000018, 0x00000000,
+       0x00000017, 0x0004003b, 0x00000018, 0x00000004, 0x00000000, 0x0003001e,
+       0x00000019, 0x00000015, 0x00040020, 0x0000001a, 0x00000009, 0x00000019,
+       0x0004003b, 0x0000001a, 0x00000005, 0x00000009, 0x00040020, 0x0000001b,
+       0x00000009, 0x00000015, 0x00040020, 0x0000001c, 0x00000000, 0x00000014,
+       0x00050036, 0x00000006, 0x00000001, 0x00000000, 0x00000007, 0x000200f8,
+       0x0000001d, 0x00050041, 0x00000011, 0x0000001e, 0x00000003, 0x0000000f,
+       0x0004003d, 0x00000009, 0x0000001f, 0x0000001e, 0x00050041, 0x0000001b,
+       0x00000020, 0x00000005, 0x0000000f, 0x0004003d, 0x00000015, 0x00000021,
+       0x00000020, 0x00050041, 0x0000001c, 0x00000022, 0x00000004, 0x00000021,
+       0x0004003d, 0x00000014, 0x00000023, 0x00000022, 0x00050041, 0x00000012,
+       0x00000024, 0x00000003, 0x00000010, 0x0004003d, 0x0000000b, 0x00000025,
+       0x00000024, 0x00050057, 0x00000009, 0x00000026, 0x00000023, 0x00000025,
+       0x00050085, 0x00000009, 0x00000027, 0x0000001f, 0x00000026, 0x0003003e,
+       0x00000002, 0x00000027, 0x000100fd, 0x00010038};
+
 } // namespace experim
@@ -1,5 +1,6 @@
 #include "VlkCapabilities.hpp"
 
+#include <algorithm>
 #include <set>
 
 #include <engine/log/ExpengineLog.hpp>
@@ -50,6 +51,37 @@ bool hasInstanceExtensionsSupport(std::vector<const char*> requiredExtensions)
     return extensionsSupported;
 }
 
+bool isInstanceExtensionAvailable(const char* extension)
+{
+    auto [result, availableExtensions] = vk::enumerateInstanceExtensionProperties();
+    if (result != vk::Result::eSuccess)
+        return false;
+
+    return std::any_of(
+        availableExtensions.begin(),
+        availableExtensions.end(),
+        [extension](const vk::ExtensionProperties& properties) {
+            return strcmp(extension, properties.extensionName) == 0;
+        });
+}
+
+bool isDeviceExtensionAvailable(
+    vk::PhysicalDevice physDevice,
+    const char* extension)
+{
+    auto [result, availableExtensions]
+        = physDevice.enumerateDeviceExtensionProperties();
+    if (result != vk::Result::eSuccess)
+        return false;
+
+    return std::any_of(
+        availableExtensions.begin(),
+        availableExtensions.end(),
+        [extension](const vk::ExtensionProperties& properties) {
+            return strcmp(extension, properties.extensionName) == 0;
+        });
+}
+
 QueueFamilyIndices findQueueFamilies(
     vk::PhysicalDevice physDevice,
     const std::vector<vk::SurfaceKHR>& surfaces)
@@ -71,7 +103,9 @@ QueueFamilyIndices findQueueFamilies(
     int currentQueueIndex = 0;
     for (const vk::QueueFamilyProperties& queueFamily : queueFamilies)
     {
-        VkBool32 presentSupport = false;
+        /* Without any surface (headless), nothing is presented and the present
+         * queue simply is the graphics queue. */
+        VkBool32 presentSupport = surfaces.empty();
         /* Ensure that this device queue can present images to every given
          * surfaces. */
         for (auto const& surface : surfaces)
@@ -131,6 +165,22 @@ QueueFamilyIndices findQueueFamilies(
         }
     }
 
+    /* A family with transfer but no graphics capabilities usually maps to a DMA
+     * engine, which copies without stealing time from the graphics queue. */
+    currentQueueIndex = 0;
+    for (const vk::QueueFamilyProperties& queueFamily : queueFamilies)
+    {
+        if (queueFamily.queueCount > 0
+            && (queueFamily.queueFlags & vk::QueueFlagBits::eTransfer)
+            && !(queueFamily.queueFlags & vk::QueueFlagBits::eGraphics))
+        {
+            queueFamilyIndices.transferFamily = currentQueueIndex;
+            if (!(queueFamily.queueFlags & vk::QueueFlagBits::eCompute))
+                break;
+        }
+        currentQueueIndex++;
+    }
+
     return queueFamilyIndices;
 }
 
@@ -196,6 +246,63 @@ bool hasPhysDeviceExtensionsSupport(
     return requiredExtensions.empty();
 }
 
+bool hasBindlessTexturesSupport(
+    vk::PhysicalDevice physDevice,
+    uint32_t textureCount)
+{
+    /* Features and limits can only be queried with this instance extension, enabled
+     * by the renderer whenever available */
+    if (!isInstanceExtensionAvailable(
+            VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+        return false;
+
+    for (const char* extension : BINDLESS_DEVICE_EXTENSIONS)
+    {
+        if (!isDeviceExtensionAvailable(physDevice, extension))
+            return false;
+    }
+
+    auto features = physDevice.getFeatures2KHR<
+        vk::PhysicalDeviceFeatures2,
+        vk::PhysicalDeviceDescriptorIndexingFeaturesEXT>();
+    const auto& coreFeatures
+        = features.get<vk::PhysicalDeviceFeatures2>().features;
+    const auto& indexingFeatures
+        = features.get<vk::PhysicalDeviceDescriptorIndexingFeaturesEXT>();
+    if (!coreFeatures.shaderSampledImageArrayDynamicIndexing
+        || !indexingFeatures.descriptorBindingSampledImageUpdateAfterBind
+        || !indexingFeatures.descriptorBindingUpdateUnusedWhilePending
+        || !indexingFeatures.descriptorBindingPartiallyBound)
+        return false;
+
+    auto properties = physDevice.getProperties2KHR<
+        vk::PhysicalDeviceProperties2,
+        vk::PhysicalDeviceDescriptorIndexingPropertiesEXT>();
+    const auto& limits
+        = properties.get<vk::PhysicalDeviceDescriptorIndexingPropertiesEXT>();
+    return limits.maxPerStageDescriptorUpdateAfterBindSamplers >= textureCount
+        && limits.maxPerStageDescriptorUpdateAfterBindSampledImages >= textureCount
+        && limits.maxDescriptorSetUpdateAfterBindSamplers >= textureCount
+        && limits.maxDescriptorSetUpdateAfterBindSampledImages >= textureCount
+        && limits.maxPerStageUpdateAfterBindResources >= textureCount;
+}
+
+bool hasTimelineSemaphoreSupport(vk::PhysicalDevice physDevice)
+{
+    /* Same as the bindless textures for the feature query */
+    if (!isInstanceExtensionAvailable(
+            VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)
+        || !isDeviceExtensionAvailable(
+            physDevice, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+        return false;
+
+    auto features = physDevice.getFeatures2KHR<
+        vk::PhysicalDeviceFeatures2,
+        vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR>();
+    return features.get<vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR>()
+        .timelineSemaphore;
+}
+
 SwapChainSupportDetails queryPhysicalDeviceSwapChainSupport(
     vk::PhysicalDevice physDevice,
     vk::SurfaceKHR surface)
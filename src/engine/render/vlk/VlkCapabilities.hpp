@@ -11,6 +11,8 @@ namespace vlk {
 struct QueueFamilyIndices {
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
+    /* Transfer-only family (DMA engine), when the device exposes one */
+    std::optional<uint32_t> transferFamily;
 
     bool isComplete()
     {
@@ -34,7 +36,19 @@ struct PhysicalDeviceDetails {
     vk::Format depthFormat;
 };
 
+/* Device extensions needed by bindless textures */
+const std::vector<const char*> BINDLESS_DEVICE_EXTENSIONS
+    = {VK_KHR_MAINTENANCE3_EXTENSION_NAME,
+       VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME};
+/* Size of the bindless texture array, declared as such by the bindless shaders */
+const uint32_t BINDLESS_TEXTURE_COUNT = 1024;
+
 bool hasInstanceExtensionsSupport(std::vector<const char*> extensions);
+/* Silent availability checks, for optional extensions */
+bool isInstanceExtensionAvailable(const char* extension);
+bool isDeviceExtensionAvailable(
+    vk::PhysicalDevice physDevice,
+    const char* extension);
 PhysicalDeviceDetails ratePhysicalDeviceSuitability(
     vk::PhysicalDevice physDevice,
     const std::vector<vk::SurfaceKHR>& surfaces,
@@ -44,6 +58,14 @@ bool hasPhysDeviceExtensionsSupport(
     vk::PhysicalDevice physDevice,
     const std::vector<const char*> deviceExtensions);
 
+/** Whether an array of textureCount combined image samplers, partially bound and
+ * updated after bind, can be indexed with a dynamically uniform index. */
+bool hasBindlessTexturesSupport(
+    vk::PhysicalDevice physDevice,
+    uint32_t textureCount);
+/** Whether VK_KHR_timeline_semaphore (core in Vulkan 1.2) can be enabled */
+bool hasTimelineSemaphoreSupport(vk::PhysicalDevice physDevice);
+
 SwapChainSupportDetails queryPhysicalDeviceSwapChainSupport(
     vk::PhysicalDevice physDevice,
     vk::SurfaceKHR surface);
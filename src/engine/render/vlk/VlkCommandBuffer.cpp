@@ -9,15 +9,19 @@ namespace {
 namespace experim {
 namespace vlk {
 
-CommandBuffer::CommandBuffer(const vlk::Device& device, vk::CommandPool commandPool)
+CommandBuffer::CommandBuffer(
+    const vlk::Device& device,
+    vk::CommandPool commandPool,
+    vk::CommandBufferLevel level)
     : commandPool_(commandPool)
+    , level_(level)
     , started_(false)
     , ended_(false)
 {
     auto [allocResult, cmdBuffers]
         = device.deviceHandle().allocateCommandBuffersUnique(
             {.commandPool = commandPool,
-             .level = vk::CommandBufferLevel::ePrimary,
+             .level = level,
              .commandBufferCount = 1});
     EXPENGINE_VK_ASSERT(allocResult, "Failed to allocate a command buffer");
 
@@ -38,6 +42,17 @@ void CommandBuffer::begin(vk::CommandBufferUsageFlags flags)
     started_ = true;
 }
 
+void CommandBuffer::begin(
+    vk::CommandBufferUsageFlags flags,
+    const vk::CommandBufferInheritanceInfo& inheritanceInfo)
+{
+    EXPENGINE_ASSERT(!started_, "begin() already called");
+    auto beginResult = commandBuffer_->begin(
+        {.flags = flags, .pInheritanceInfo = &inheritanceInfo});
+    EXPENGINE_VK_ASSERT(beginResult, "Failed to begin a command buffer");
+    started_ = true;
+}
+
 void CommandBuffer::end()
 {
     EXPENGINE_ASSERT(
@@ -56,5 +71,63 @@ void CommandBuffer::copyBufferToImage(
         buffer, image, vk::ImageLayout::eTransferDstOptimal, copyRegion);
 }
 
+void CommandBuffer::copyBuffer(
+    vk::Buffer srcBuffer,
+    vk::Buffer dstBuffer,
+    const vk::BufferCopy& copyRegion)
+{
+    commandBuffer_->copyBuffer(srcBuffer, dstBuffer, copyRegion);
+}
+
+void CommandBuffer::copyImageToBuffer(
+    vk::Image image,
+    vk::Buffer buffer,
+    const vk::BufferImageCopy& copyRegion)
+{
+    commandBuffer_->copyImageToBuffer(
+        image, vk::ImageLayout::eTransferSrcOptimal, buffer, copyRegion);
+}
+void CommandBuffer::blitImage(
+    vk::Image srcImage,
+    vk::Image dstImage,
+    const vk::ImageBlit& blitRegion,
+    vk::Filter filter)
+{
+    commandBuffer_->blitImage(
+        srcImage,
+        vk::ImageLayout::eTransferSrcOptimal,
+        dstImage,
+        vk::ImageLayout::eTransferDstOptimal,
+        blitRegion,
+        filter);
+}
+
+void CommandBuffer::pipelineBarrier(
+    vk::PipelineStageFlags srcStageMask,
+    vk::PipelineStageFlags dstStageMask,
+    const vk::MemoryBarrier& memoryBarrier)
+{
+    commandBuffer_->pipelineBarrier(
+        srcStageMask, dstStageMask, {}, memoryBarrier, nullptr, nullptr);
+}
+
+void CommandBuffer::pipelineBarrier(
+    vk::PipelineStageFlags srcStageMask,
+    vk::PipelineStageFlags dstStageMask,
+    const vk::ImageMemoryBarrier& imageBarrier)
+{
+    commandBuffer_->pipelineBarrier(
+        srcStageMask, dstStageMask, {}, nullptr, nullptr, imageBarrier);
+}
+
+void CommandBuffer::pipelineBarrier(
+    vk::PipelineStageFlags srcStageMask,
+    vk::PipelineStageFlags dstStageMask,
+    const vk::BufferMemoryBarrier& bufferBarrier)
+{
+    commandBuffer_->pipelineBarrier(
+        srcStageMask, dstStageMask, {}, nullptr, bufferBarrier, nullptr);
+}
+
 } // namespace vlk
 } // namespace experim
@@ -9,19 +9,54 @@ class Device;
 
 class CommandBuffer {
 public:
-    CommandBuffer(const vlk::Device& device, vk::CommandPool commandPool);
+    CommandBuffer(
+        const vlk::Device& device,
+        vk::CommandPool commandPool,
+        vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary);
 
     inline const vk::CommandBuffer getHandle() const { return commandBuffer_.get(); }
+    inline vk::CommandBufferLevel level() const { return level_; }
 
     virtual void reset();
 
     void begin(vk::CommandBufferUsageFlags flags);
+    /** Secondary command buffers */
+    void begin(
+        vk::CommandBufferUsageFlags flags,
+        const vk::CommandBufferInheritanceInfo& inheritanceInfo);
     void end();
 
     void copyBufferToImage(
         vk::Buffer buffer,
         vk::Image image,
         const vk::BufferImageCopy& copyRegion);
+    void copyBuffer(
+        vk::Buffer srcBuffer,
+        vk::Buffer dstBuffer,
+        const vk::BufferCopy& copyRegion);
+    void copyImageToBuffer(
+        vk::Image image,
+        vk::Buffer buffer,
+        const vk::BufferImageCopy& copyRegion);
+    /** From srcImage in TransferSrcOptimal layout to dstImage in
+     * TransferDstOptimal layout */
+    void blitImage(
+        vk::Image srcImage,
+        vk::Image dstImage,
+        const vk::ImageBlit& blitRegion,
+        vk::Filter filter);
+    void pipelineBarrier(
+        vk::PipelineStageFlags srcStageMask,
+        vk::PipelineStageFlags dstStageMask,
+        const vk::MemoryBarrier& memoryBarrier);
+    void pipelineBarrier(
+        vk::PipelineStageFlags srcStageMask,
+        vk::PipelineStageFlags dstStageMask,
+        const vk::ImageMemoryBarrier& imageBarrier);
+    void pipelineBarrier(
+        vk::PipelineStageFlags srcStageMask,
+        vk::PipelineStageFlags dstStageMask,
+        const vk::BufferMemoryBarrier& bufferBarrier);
 
 protected:
     /* Handles */
@@ -29,6 +64,8 @@ protected:
     /* Owned */
     vk::UniqueCommandBuffer commandBuffer_;
 
+    vk::CommandBufferLevel level_;
+
     bool started_;
     bool ended_;
 };
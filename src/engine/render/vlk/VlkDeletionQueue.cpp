@@ -0,0 +1,71 @@
+#include "VlkDeletionQueue.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <engine/render/vlk/VlkQueueTimeline.hpp>
+
+namespace experim {
+namespace vlk {
+
+DeletionQueue::DeletionQueue(QueueTimeline& timeline)
+    : timeline_(timeline)
+{
+}
+
+DeletionQueue::~DeletionQueue()
+{
+    /* Waited and destroyed outside of the lock, as in collect(). Repeated since
+     * these destructors may release other objects. */
+    while (true)
+    {
+        std::deque<PendingObject> pendingObjects;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pendingObjects.swap(pending_);
+        }
+        if (pendingObjects.empty())
+            break;
+
+        uint64_t value = 0;
+        for (const auto& pending : pendingObjects)
+        {
+            value = std::max(value, pending.value);
+        }
+        timeline_.wait(value);
+        pendingObjects.clear();
+    }
+}
+
+void DeletionQueue::collect()
+{
+    /* Destroyed outside of the lock : destructors may release other objects */
+    std::vector<std::shared_ptr<void>> reachedObjects;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto reachedIt = std::stable_partition(
+            pending_.begin(), pending_.end(), [this](const PendingObject& pending) {
+                return !timeline_.isReached(pending.value);
+            });
+        for (auto it = reachedIt; it != pending_.end(); it++)
+        {
+            reachedObjects.push_back(std::move(it->object));
+        }
+        pending_.erase(reachedIt, pending_.end());
+    }
+}
+
+size_t DeletionQueue::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+void DeletionQueue::push(std::shared_ptr<void> object, uint64_t value)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.push_back({.value = value, .object = std::move(object)});
+}
+
+} // namespace vlk
+} // namespace experim
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace experim {
+namespace vlk {
+
+class QueueTimeline;
+
+/**
+ * Destroys the GPU objects once the submissions using them are complete, without
+ * waiting : Buffer, VlkImage, views, pipelines... The owner of an object releases
+ * it with the timeline value of its last use, for example the latest value
+ * submitted by a RenderingContext, instead of waiting for the GPU to be idle.
+ *
+ * Released objects are destroyed by collect(), called once per frame by the
+ * renderer.
+ *
+ * Thread-safe.
+ */
+class DeletionQueue {
+public:
+    DeletionQueue(QueueTimeline& timeline);
+    /** Waits for the pending objects, then destroys them */
+    ~DeletionQueue();
+
+    DeletionQueue(const DeletionQueue&) = delete;
+    DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+    /** Destroys object once the timeline reaches value. Any movable owner : a
+     * std::unique_ptr, a vk::UniqueHandle... */
+    template <typename T> void release(T object, uint64_t value)
+    {
+        push(std::make_shared<T>(std::move(object)), value);
+    }
+
+    /** Destroys the objects whose value is reached. Non-blocking. */
+    void collect();
+
+    size_t pendingCount() const;
+
+private:
+    struct PendingObject {
+        uint64_t value;
+        std::shared_ptr<void> object;
+    };
+
+    /* References */
+    QueueTimeline& timeline_;
+
+    /* Owned objects */
+    mutable std::mutex mutex_;
+    /* Release order, values are not necessarily sorted */
+    std::deque<PendingObject> pending_;
+
+    void push(std::shared_ptr<void> object, uint64_t value);
+};
+
+} // namespace vlk
+} // namespace experim
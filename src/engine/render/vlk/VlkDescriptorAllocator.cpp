@@ -0,0 +1,130 @@
+#include "VlkDescriptorAllocator.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include <engine/log/ExpengineLog.hpp>
+#include <engine/render/vlk/VlkDebug.hpp>
+#include <engine/render/vlk/VlkDevice.hpp>
+
+namespace {
+
+/* Each new pool holds twice the sets of the previous one, up to this count */
+const uint32_t MAX_SETS_PER_POOL = 4096;
+
+} // namespace
+
+namespace experim {
+namespace vlk {
+
+DescriptorAllocator::DescriptorAllocator(
+    const vlk::Device& device,
+    const std::vector<vk::DescriptorPoolSize>& descriptorsPerSet,
+    uint32_t initialSetsPerPool)
+    : device_(device)
+    , descriptorsPerSet_(descriptorsPerSet)
+    , setsPerPool_(std::clamp(initialSetsPerPool, 1u, MAX_SETS_PER_POOL))
+    , logger_(spdlog::get(LOGGER_NAME))
+{
+}
+
+DescriptorAllocator::~DescriptorAllocator()
+{
+    SPDLOG_LOGGER_DEBUG(
+        logger_, "DescriptorAllocator destruction, {} pool(s)", poolCount());
+}
+
+vk::DescriptorSet DescriptorAllocator::allocate(vk::DescriptorSetLayout layout)
+{
+    std::lock_guard<std::mutex> lock(poolsMutex_);
+
+    vk::DescriptorSetAllocateInfo allocateInfo {
+        .descriptorSetCount = 1, .pSetLayouts = &layout};
+    vk::DescriptorSet descriptorSet;
+
+    /* The sets count of the pools is tracked, since Vulkan 1.0 does not
+     * guarantee a specific error on an exhausted pool. A fragmented pool is
+     * retired the same way. */
+    Pool* pool = &currentPool();
+    allocateInfo.descriptorPool = pool->handle.get();
+    auto result = device_.deviceHandle().allocateDescriptorSets(
+        &allocateInfo, &descriptorSet);
+    if (result == vk::Result::eErrorOutOfPoolMemory
+        || result == vk::Result::eErrorFragmentedPool)
+    {
+        retireCurrentPool();
+        pool = &currentPool();
+        allocateInfo.descriptorPool = pool->handle.get();
+        result = device_.deviceHandle().allocateDescriptorSets(
+            &allocateInfo, &descriptorSet);
+    }
+    EXPENGINE_VK_ASSERT(result, "Failed to allocate a descriptor set");
+
+    pool->allocatedSets++;
+    if (pool->allocatedSets == pool->maxSets)
+        retireCurrentPool();
+
+    return descriptorSet;
+}
+
+void DescriptorAllocator::reset()
+{
+    std::lock_guard<std::mutex> lock(poolsMutex_);
+
+    for (auto pools : {&availablePools_, &fullPools_})
+    {
+        for (auto& pool : *pools)
+        {
+            auto res = device_.deviceHandle().resetDescriptorPool(
+                pool.handle.get(), {});
+            EXPENGINE_VK_ASSERT(res, "Failed to reset a descriptor pool");
+            pool.allocatedSets = 0;
+        }
+    }
+    std::move(
+        fullPools_.begin(), fullPools_.end(), std::back_inserter(availablePools_));
+    fullPools_.clear();
+}
+
+size_t DescriptorAllocator::poolCount() const
+{
+    std::lock_guard<std::mutex> lock(poolsMutex_);
+    return availablePools_.size() + fullPools_.size();
+}
+
+DescriptorAllocator::Pool& DescriptorAllocator::currentPool()
+{
+    if (!availablePools_.empty())
+        return availablePools_.back();
+
+    std::vector<vk::DescriptorPoolSize> poolSizes = descriptorsPerSet_;
+    for (auto& poolSize : poolSizes)
+    {
+        poolSize.descriptorCount *= setsPerPool_;
+    }
+    auto [result, descriptorPool]
+        = device_.deviceHandle().createDescriptorPoolUnique(
+            {.maxSets = setsPerPool_,
+             .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+             .pPoolSizes = poolSizes.data()});
+    EXPENGINE_VK_ASSERT(result, "Failed to create a descriptor pool");
+    SPDLOG_LOGGER_DEBUG(
+        logger_, "Descriptor pool created for {} sets", setsPerPool_);
+
+    availablePools_.push_back(
+        {.handle = std::move(descriptorPool),
+         .maxSets = setsPerPool_,
+         .allocatedSets = 0});
+    setsPerPool_ = std::min(setsPerPool_ * 2, MAX_SETS_PER_POOL);
+
+    return availablePools_.back();
+}
+
+void DescriptorAllocator::retireCurrentPool()
+{
+    fullPools_.push_back(std::move(availablePools_.back()));
+    availablePools_.pop_back();
+}
+
+} // namespace vlk
+} // namespace experim
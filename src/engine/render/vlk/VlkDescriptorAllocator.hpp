@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <engine/render/vlk/VlkInclude.hpp>
+
+namespace spdlog {
+class logger;
+}
+
+namespace experim {
+namespace vlk {
+
+class Device;
+
+/**
+ * Allocates the descriptor sets of one layout class : the layouts whose sets hold
+ * descriptorsPerSet. Pools are created on demand, each one bigger than the
+ * previous, so allocations never fail on an exhausted pool.
+ *
+ * Sets are not freed individually : they live until reset(), which recycles every
+ * pool at once. A per-frame allocator can thus be reset once the frame fence is
+ * signaled.
+ *
+ * Thread-safe.
+ */
+class DescriptorAllocator {
+public:
+    DescriptorAllocator(
+        const vlk::Device& device,
+        const std::vector<vk::DescriptorPoolSize>& descriptorsPerSet,
+        uint32_t initialSetsPerPool = 64);
+    ~DescriptorAllocator();
+
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+    /** layout must belong to the class of the allocator */
+    vk::DescriptorSet allocate(vk::DescriptorSetLayout layout);
+    /** Frees all the allocated sets. They must not be in use by the GPU anymore. */
+    void reset();
+
+    size_t poolCount() const;
+
+private:
+    struct Pool {
+        vk::UniqueDescriptorPool handle;
+        uint32_t maxSets;
+        uint32_t allocatedSets;
+    };
+
+    /* References */
+    const vlk::Device& device_;
+
+    /* Configuration */
+    const std::vector<vk::DescriptorPoolSize> descriptorsPerSet_;
+    /* Size of the next created pool */
+    uint32_t setsPerPool_;
+
+    /* Owned objects */
+    mutable std::mutex poolsMutex_;
+    /* The last one is the current pool */
+    std::vector<Pool> availablePools_;
+    std::vector<Pool> fullPools_;
+
+    /* Logging */
+    std::shared_ptr<spdlog::logger> logger_;
+
+    /* Returns the current pool, creating it if needed */
+    Pool& currentPool();
+    void retireCurrentPool();
+};
+
+} // namespace vlk
+} // namespace experim
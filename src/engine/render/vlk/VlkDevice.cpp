@@ -8,6 +8,11 @@
 
 #include <engine/log/ExpengineLog.hpp>
 #include <engine/render/vlk/VlkDebug.hpp>
+#include <engine/render/vlk/VlkDeletionQueue.hpp>
+#include <engine/render/vlk/VlkDescriptorAllocator.hpp>
+#include <engine/render/vlk/VlkPipelineCache.hpp>
+#include <engine/render/vlk/VlkQueueTimeline.hpp>
+#include <engine/render/vlk/VlkUploader.hpp>
 #include <engine/render/vlk/VlkWindow.hpp>
 
 namespace experim {
@@ -18,28 +23,73 @@ const std::vector<const char*> DEVICE_EXTENSIONS = {VK_KHR_SWAPCHAIN_EXTENSION_N
 Device::Device(
     vk::Instance vkInstance,
     const vk::DispatchLoaderDynamic& dispatchLoader,
-    std::shared_ptr<spdlog::logger> logger)
+    std::shared_ptr<spdlog::logger> logger,
+    bool headless,
+    const std::string& pipelineCachePath)
     : vkInstance_(vkInstance)
     , logger_(logger)
 {
-    /* Create a temporary dummy window/surface to get information
-     * about surface compatibility between the Vulkan devices
-     * selected/created and the surfaces that will be in use during the
-     * application runtime. */
-    SPDLOG_LOGGER_DEBUG(
-        logger_, "Dummy window creation for surface compatibility checks");
-    auto dummyWindow = std::make_unique<VulkanWindow>();
-    auto [surfaceCreated, dummySurface] = dummyWindow->createVkSurface(vkInstance);
-    EXPENGINE_ASSERT(surfaceCreated, "Failed to create a VkSurface");
-    auto windowSurface_ = vk::UniqueSurfaceKHR(dummySurface, vkInstance);
-
-    /* Devices */
-    physDevice_ = pickPhysicalDevice(
-        vkInstance,
-        DEVICE_EXTENSIONS,
-        std::vector<vk::SurfaceKHR> {*windowSurface_});
+    std::vector<const char*> deviceExtensions;
+    if (headless)
+    {
+        /* No surface to be compatible with and nothing to present : no swapchain
+         * extension needed. */
+        SPDLOG_LOGGER_DEBUG(logger_, "Headless device creation");
+        physDevice_ = pickPhysicalDevice(vkInstance, deviceExtensions, {});
+    }
+    else
+    {
+        /* Create a temporary dummy window/surface to get information
+         * about surface compatibility between the Vulkan devices
+         * selected/created and the surfaces that will be in use during the
+         * application runtime. */
+        SPDLOG_LOGGER_DEBUG(
+            logger_, "Dummy window creation for surface compatibility checks");
+        auto dummyWindow = std::make_unique<VulkanWindow>();
+        auto [surfaceCreated, dummySurface]
+            = dummyWindow->createVkSurface(vkInstance);
+        EXPENGINE_ASSERT(surfaceCreated, "Failed to create a VkSurface");
+        auto windowSurface_ = vk::UniqueSurfaceKHR(dummySurface, vkInstance);
+
+        /* Devices */
+        deviceExtensions = DEVICE_EXTENSIONS;
+        physDevice_ = pickPhysicalDevice(
+            vkInstance,
+            deviceExtensions,
+            std::vector<vk::SurfaceKHR> {*windowSurface_});
+    }
+
+    /* Optional features */
+    bindlessTextures_
+        = hasBindlessTexturesSupport(physDevice_.device, BINDLESS_TEXTURE_COUNT);
+    if (bindlessTextures_)
+    {
+        deviceExtensions.insert(
+            deviceExtensions.end(),
+            BINDLESS_DEVICE_EXTENSIONS.begin(),
+            BINDLESS_DEVICE_EXTENSIONS.end());
+    }
+    SPDLOG_LOGGER_INFO(
+        logger_, "Bindless textures {}", bindlessTextures_ ? "enabled" : "disabled");
+    timelineSemaphores_ = hasTimelineSemaphoreSupport(physDevice_.device);
+    if (timelineSemaphores_)
+        deviceExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+    SPDLOG_LOGGER_INFO(
+        logger_,
+        "Timeline semaphores {}",
+        timelineSemaphores_ ? "enabled" : "disabled");
+
     logicalDevice_ = createLogicalDevice(
-        physDevice_.device, physDevice_.queuesIndices, DEVICE_EXTENSIONS);
+        physDevice_.device, physDevice_.queuesIndices, deviceExtensions);
+
+    /* Timestamps support */
+    auto queueFamilies = physDevice_.device.getQueueFamilyProperties();
+    const auto& graphicsFamily
+        = queueFamilies.at(physDevice_.queuesIndices.graphicsFamily.value());
+    timestampValidBits_ = graphicsFamily.timestampValidBits;
+    timestampPeriod_ = timestampValidBits_ > 0
+        ? physDevice_.properties.limits.timestampPeriod
+        : 0.0f;
 
     /* Memory allocator */
     memAllocator_ = std::make_unique<vlk::MemoryAllocator>(
@@ -50,9 +100,16 @@ Device::Device(
         physDevice_.queuesIndices.graphicsFamily.value(), 0);
     presentQueue_ = logicalDevice_->getQueue(
         physDevice_.queuesIndices.presentFamily.value(), 0);
+    transferQueue_ = hasDedicatedTransferQueue()
+        ? logicalDevice_->getQueue(transferFamily(), 0)
+        : graphicsQueue_;
 
-    /* Descriptor pool */
-    descriptorPool_ = createDescriptorPool();
+    /* Descriptor sets of textures */
+    descriptorAllocator_ = std::make_unique<DescriptorAllocator>(
+        *this,
+        std::vector<vk::DescriptorPoolSize> {
+            {.type = vk::DescriptorType::eCombinedImageSampler,
+             .descriptorCount = 1}});
 
     /* Command pool for short lived buffers */
     auto cmdPoolResult = logicalDevice_->createCommandPoolUnique(
@@ -61,6 +118,22 @@ Device::Device(
     EXPENGINE_VK_ASSERT(
         cmdPoolResult.result, "Failed to create the device transient command pool");
     transientCommandPool_ = std::move(cmdPoolResult.value);
+
+    pipelineCache_
+        = std::make_unique<PipelineCache>(*this, pipelineCachePath, logger_);
+
+    /* Submissions tracking */
+    graphicsTimeline_ = std::make_unique<QueueTimeline>(
+        *this, graphicsQueue_, timelineSemaphores_);
+    deletionQueue_ = std::make_unique<DeletionQueue>(*graphicsTimeline_);
+
+    /* Asynchronous uploads */
+    uploader_ = std::make_unique<Uploader>(*this);
+    SPDLOG_LOGGER_DEBUG(
+        logger_,
+        "Uploads use {}",
+        hasDedicatedTransferQueue() ? "a dedicated transfer queue"
+                                    : "the graphics queue");
 }
 
 Device::~Device() { SPDLOG_LOGGER_DEBUG(logger_, "Device destruction"); }
@@ -99,7 +172,8 @@ const void Device::submitTransientCommandBuffer(CommandBuffer& commandBuffer) co
 
     auto handle = commandBuffer.getHandle();
     vk::SubmitInfo submitInfo {.commandBufferCount = 1, .pCommandBuffers = &handle};
-    /* TODO : Could implement fences for transient buffers ? */
+    /* Blocking : resources uploads should go through the Uploader instead */
+    std::lock_guard<std::mutex> queueLock(queueMutex_);
     auto res = graphicsQueue_.submit(submitInfo, nullptr);
     EXPENGINE_VK_ASSERT(
         res, "Failed to submit transient command buffer to graphics queue");
@@ -110,6 +184,7 @@ const void Device::submitTransientCommandBuffer(CommandBuffer& commandBuffer) co
 
 void Device::waitIdle() const
 {
+    std::lock_guard<std::mutex> queueLock(queueMutex_);
     auto res = logicalDevice_->waitIdle();
     EXPENGINE_VK_ASSERT(res, "Failed to wait on the logical device to be idle");
 }
@@ -162,6 +237,11 @@ vk::UniqueDevice Device::createLogicalDevice(
     std::set<uint32_t> uniqueQueueFamiliesIndexes
         = {queueFamilyIndices.graphicsFamily.value(),
            queueFamilyIndices.presentFamily.value()};
+    if (queueFamilyIndices.transferFamily.has_value())
+    {
+        uniqueQueueFamiliesIndexes.insert(
+            queueFamilyIndices.transferFamily.value());
+    }
 
     const float queuePriority = 1.0f;
     /* The currently available drivers will only allow you to create a
@@ -179,7 +259,6 @@ vk::UniqueDevice Device::createLogicalDevice(
         queueCreatesInfos.push_back(queueCreateInfo);
     }
 
-    /* No features yet */
     vk::PhysicalDeviceFeatures deviceFeatures = {};
     vk::DeviceCreateInfo createInfo = {
         .queueCreateInfoCount = static_cast<uint32_t>(queueCreatesInfos.size()),
@@ -190,6 +269,27 @@ vk::UniqueDevice Device::createLogicalDevice(
         .pEnabledFeatures = &deviceFeatures,
     };
 
+    /* Bindless textures : indexed with a push constant, written while in use */
+    vk::PhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures {
+        .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+        .descriptorBindingUpdateUnusedWhilePending = VK_TRUE,
+        .descriptorBindingPartiallyBound = VK_TRUE};
+    if (bindlessTextures_)
+    {
+        deviceFeatures.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+        createInfo.pNext = &descriptorIndexingFeatures;
+    }
+
+    /* Timeline semaphores : frame and upload completion. Prepended to the
+     * features chain. */
+    vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeatures {
+        .timelineSemaphore = VK_TRUE};
+    if (timelineSemaphores_)
+    {
+        timelineSemaphoreFeatures.pNext = const_cast<void*>(createInfo.pNext);
+        createInfo.pNext = &timelineSemaphoreFeatures;
+    }
+
     /* https://www.khronos.org/registry/vulkan/specs/1.1-extensions/html/vkspec.html#extendingvulkan-layers-devicelayerdeprecation
      * EnabledLayerCount and ppEnabledLayerNames fields of
      * VkDeviceCreateInfo are ignored by up-to-date implementations. It is
@@ -208,29 +308,6 @@ vk::UniqueDevice Device::createLogicalDevice(
     return std::move(device);
 }
 
-vk::UniqueDescriptorPool Device::createDescriptorPool() const
-{
-    /* TODO what's the right count ? All the different VK_DESCRIPTOR_TYPE
-     * allocated in the ImGui example do not seem necessary here */
-    const uint32_t descriptorCount = 100;
-    std::vector<vk::DescriptorPoolSize> descriptorPoolSizes {
-        {.type = vk::DescriptorType::eCombinedImageSampler,
-         .descriptorCount = descriptorCount}};
-
-    vk::DescriptorPoolCreateInfo descriptorPoolInfo {
-        .maxSets
-        = static_cast<uint32_t>(descriptorCount * descriptorPoolSizes.size()),
-        .poolSizeCount = static_cast<uint32_t>(descriptorPoolSizes.size()),
-        .pPoolSizes = descriptorPoolSizes.data(),
-    };
-    auto [result, descriptorPool]
-        = logicalDevice_->createDescriptorPoolUnique(descriptorPoolInfo);
-
-    EXPENGINE_VK_ASSERT(result, "Failed to create the descriptor pool");
-
-    return std::move(descriptorPool);
-}
-
 uint32_t Device::findMemoryType(
     uint32_t typeFilter,
     vk::MemoryPropertyFlags properties) const
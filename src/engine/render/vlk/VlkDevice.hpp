@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include <engine/render/vlk/VlkCapabilities.hpp>
@@ -15,14 +17,21 @@ class logger;
 namespace experim {
 namespace vlk {
 
+class DeletionQueue;
+class DescriptorAllocator;
 class MemoryAllocator;
+class PipelineCache;
+class QueueTimeline;
+class Uploader;
 
 class Device {
 public:
     Device(
         vk::Instance vkInstance,
         const vk::DispatchLoaderDynamic& dispatchLoader,
-        std::shared_ptr<spdlog::logger> logger);
+        std::shared_ptr<spdlog::logger> logger,
+        bool headless = false,
+        const std::string& pipelineCachePath = "");
     ~Device();
 
     /* Public accessors */
@@ -36,17 +45,56 @@ public:
     {
         return physDevice_.queuesIndices;
     }
+    inline const vk::PhysicalDeviceProperties& properties() const
+    {
+        return physDevice_.properties;
+    }
     inline const vk::Format getDepthFormat() const
     {
         return physDevice_.depthFormat;
     }
-    inline const vk::DescriptorPool descriptorPool() const
+    /** Persistent descriptor sets made of one combined image sampler */
+    inline DescriptorAllocator& descriptorAllocator() const
     {
-        return descriptorPool_.get();
+        return *descriptorAllocator_;
     }
     inline const vk::Queue graphicsQueue() const { return graphicsQueue_; }
     inline const vk::Queue presentQueue() const { return presentQueue_; }
+    /** Dedicated transfer queue, or the graphics queue if the device has no
+     * transfer-only family. */
+    inline const vk::Queue transferQueue() const { return transferQueue_; }
+    inline uint32_t transferFamily() const
+    {
+        return physDevice_.queuesIndices.transferFamily.value_or(
+            physDevice_.queuesIndices.graphicsFamily.value());
+    }
+    inline bool hasDedicatedTransferQueue() const
+    {
+        return physDevice_.queuesIndices.transferFamily.has_value();
+    }
+    /** Queues are externally synchronized objects : to be held for any submission
+     * or presentation, since uploads may be submitted from any thread. */
+    inline std::mutex& queueMutex() const { return queueMutex_; }
+    /** Completion values of the graphics queue submissions : frames and uploads
+     * are tracked, and waited on, through it */
+    inline QueueTimeline& graphicsTimeline() const { return *graphicsTimeline_; }
+    /** Objects to destroy once the graphics timeline reaches a value */
+    inline DeletionQueue& deletionQueue() const { return *deletionQueue_; }
+    /** Whether the timelines use timeline semaphores rather than fences */
+    inline bool hasTimelineSemaphores() const { return timelineSemaphores_; }
     inline const MemoryAllocator& allocator() const { return *memAllocator_; }
+    inline Uploader& uploader() const { return *uploader_; }
+    /** Device-level pipeline cache, persisted across runs */
+    inline PipelineCache& pipelineCache() const { return *pipelineCache_; }
+    /** Whether the device supports an array of BINDLESS_TEXTURE_COUNT textures,
+     * indexed per draw. See TextureTable. */
+    inline bool hasBindlessTextures() const { return bindlessTextures_; }
+    /** Nanoseconds per timestamp tick. 0 if the graphics queue can't write
+     * timestamps. */
+    inline float timestampPeriod() const { return timestampPeriod_; }
+    /** Bits of the timestamps written by the graphics queue. The higher bits are
+     * undefined. */
+    inline uint32_t timestampValidBits() const { return timestampValidBits_; }
 
     /* Surface support */
     const SwapChainSupportDetails querySwapChainSupport(
@@ -68,16 +116,32 @@ private:
     /* Instance handle */
     const vk::Instance vkInstance_;
 
+    /* Handles. Declared before the owned objects : they are destroyed after them,
+     * and the destructors of the uploader and timeline still submit and wait. */
+    vk::Queue graphicsQueue_;
+    vk::Queue presentQueue_;
+    vk::Queue transferQueue_;
+    mutable std::mutex queueMutex_;
+
     /* Owned objects */
     PhysicalDeviceDetails physDevice_;
     vk::UniqueDevice logicalDevice_;
     std::unique_ptr<MemoryAllocator> memAllocator_;
-    vk::UniqueDescriptorPool descriptorPool_;
+    std::unique_ptr<DescriptorAllocator> descriptorAllocator_;
     vk::UniqueCommandPool transientCommandPool_;
-
-    /* Handles */
-    vk::Queue graphicsQueue_;
-    vk::Queue presentQueue_;
+    std::unique_ptr<PipelineCache> pipelineCache_;
+    /* Destroyed after the uploader, which waits on it */
+    std::unique_ptr<QueueTimeline> graphicsTimeline_;
+    /* Holds resources of the allocator, waits on the timeline */
+    std::unique_ptr<DeletionQueue> deletionQueue_;
+    /* Destroyed first : waits for the pending uploads */
+    std::unique_ptr<Uploader> uploader_;
+
+    /* Properties */
+    float timestampPeriod_;
+    uint32_t timestampValidBits_;
+    bool bindlessTextures_;
+    bool timelineSemaphores_;
 
     /* Logging */
     std::shared_ptr<spdlog::logger> logger_;
@@ -91,8 +155,6 @@ private:
         vk::PhysicalDevice physicalDevice,
         QueueFamilyIndices queueFamilyIndices,
         const std::vector<const char*> deviceExtensions) const;
-
-    vk::UniqueDescriptorPool createDescriptorPool() const;
 };
 } // namespace vlk
 } // namespace experim
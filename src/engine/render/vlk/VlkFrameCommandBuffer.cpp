@@ -15,19 +15,31 @@ FrameCommandBuffer::FrameCommandBuffer(
     vk::CommandPool commandPool,
     vk::RenderPass renderPass,
     vk::Framebuffer framebuffer,
-    vk::Extent2D extent)
-    : CommandBuffer(device, commandPool)
+    vk::Extent2D extent,
+    vk::CommandBufferLevel level)
+    : CommandBuffer(device, commandPool, level)
     , renderPass_(renderPass)
     , framebuffer_(framebuffer)
     , extent_(extent)
+    , timestampPool_(nullptr)
+    , firstTimestampQuery_(0)
     , bindedPipelineLayout_(nullptr)
     , pushOffset_(0)
     , renderPassStarted_(false)
     , renderPassEnded_(false)
+    , subpassContents_(vk::SubpassContents::eInline)
 {
 }
 
-void FrameCommandBuffer::beginRenderPass()
+void FrameCommandBuffer::setTimestampQueries(
+    vk::QueryPool queryPool,
+    uint32_t firstQuery)
+{
+    timestampPool_ = queryPool;
+    firstTimestampQuery_ = firstQuery;
+}
+
+void FrameCommandBuffer::beginRenderPass(vk::SubpassContents contents)
 {
     /* TODO here get values for clear color */
     std::array<float, 4> clearValue = {0.0f, 0.0f, 0.0f, 1.0f};
@@ -45,8 +57,19 @@ void FrameCommandBuffer::beginRenderPass()
     EXPENGINE_ASSERT(
         started_ && !renderPassStarted_,
         "beginRenderPass() called before calling begin() or called twice");
-    commandBuffer_->beginRenderPass(info, vk::SubpassContents::eInline);
+    EXPENGINE_ASSERT(
+        level_ == vk::CommandBufferLevel::ePrimary,
+        "Secondary command buffers inherit the render pass");
+    if (timestampPool_)
+    {
+        commandBuffer_->writeTimestamp(
+            vk::PipelineStageFlagBits::eTopOfPipe,
+            timestampPool_,
+            firstTimestampQuery_);
+    }
+    commandBuffer_->beginRenderPass(info, contents);
     renderPassStarted_ = true;
+    subpassContents_ = contents;
 }
 
 void FrameCommandBuffer::endRenderPass()
@@ -55,17 +78,34 @@ void FrameCommandBuffer::endRenderPass()
         renderPassStarted_ && !renderPassEnded_,
         "endRenderPass() called before beginRenderPass() or called twice");
     commandBuffer_->endRenderPass();
+    if (timestampPool_)
+    {
+        commandBuffer_->writeTimestamp(
+            vk::PipelineStageFlagBits::eBottomOfPipe,
+            timestampPool_,
+            firstTimestampQuery_ + 1);
+    }
     renderPassEnded_ = true;
 }
 
+void FrameCommandBuffer::executeCommands(
+    vk::ArrayProxy<const vk::CommandBuffer> const& commandBuffers)
+{
+    EXPENGINE_ASSERT(
+        renderPassStarted_ && !renderPassEnded_
+            && subpassContents_ == vk::SubpassContents::eSecondaryCommandBuffers,
+        "executeCommands() called outside of a render pass with secondary contents");
+    commandBuffer_->executeCommands(commandBuffers);
+}
+
 void FrameCommandBuffer::reset()
 {
-    /* TODO Reset in FrameCommandBuffer should be linked to the reset of the
-     * underlying buffer */
     renderPassStarted_ = false;
     renderPassEnded_ = false;
     pushOffset_ = 0;
     bindedPipelineLayout_ = nullptr;
+    timestampPool_ = nullptr;
+    firstTimestampQuery_ = 0;
     CommandBuffer::reset();
 }
 
@@ -82,14 +122,28 @@ void FrameCommandBuffer::bind(
     pushOffset_ = 0;
 }
 
+void FrameCommandBuffer::bindDescriptorSet(vk::DescriptorSet descriptor)
+{
+    EXPENGINE_ASSERT(
+        bindedPipelineLayout_,
+        "Failed to bind a descriptor set : no pipeline layout binded");
+    commandBuffer_->bindDescriptorSets(
+        vk::PipelineBindPoint::eGraphics,
+        bindedPipelineLayout_,
+        0,
+        descriptor,
+        nullptr);
+}
+
 void FrameCommandBuffer::bindBuffers(
     const Buffer& vertexBuffer,
     const Buffer& indexBuffer,
-    vk::IndexType indexType)
+    vk::IndexType indexType,
+    vk::DeviceSize vertexOffset,
+    vk::DeviceSize indexOffset)
 {
-    uint32_t vertexOffset = 0;
     commandBuffer_->bindVertexBuffers(0, vertexBuffer.getHandle(), vertexOffset);
-    commandBuffer_->bindIndexBuffer(indexBuffer.getHandle(), 0, indexType);
+    commandBuffer_->bindIndexBuffer(indexBuffer.getHandle(), indexOffset, indexType);
 }
 
 void FrameCommandBuffer::setViewport(uint32_t width, uint32_t height)
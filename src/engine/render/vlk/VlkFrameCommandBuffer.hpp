@@ -16,22 +16,48 @@ public:
         vk::CommandPool commandPool,
         vk::RenderPass renderPass,
         vk::Framebuffer framebuffer,
-        vk::Extent2D extent);
+        vk::Extent2D extent,
+        vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary);
 
+    /** Only resets the recording state : the Vulkan command buffer is reset with
+     * its pool. */
     void reset() override;
 
-    void beginRenderPass();
+    /** Target of the next render pass. Set by the pool while not recording : the
+     * framebuffer depends on the acquired image. */
+    inline void setFramebuffer(vk::Framebuffer framebuffer)
+    {
+        framebuffer_ = framebuffer;
+    };
+
+    /** Makes the render pass write a timestamp at its start (firstQuery) and at its
+     * end (firstQuery + 1). Must be called before beginRenderPass. The queries are
+     * reset by the caller : they stay unavailable without a render pass. */
+    void setTimestampQueries(vk::QueryPool queryPool, uint32_t firstQuery);
+
+    /** With eSecondaryCommandBuffers, the render pass content can only be recorded
+     * by executeCommands. */
+    void beginRenderPass(
+        vk::SubpassContents contents = vk::SubpassContents::eInline);
     void endRenderPass();
+    /** Executes ended secondary command buffers inside the render pass */
+    void executeCommands(
+        vk::ArrayProxy<const vk::CommandBuffer> const& commandBuffers);
 
     void bind(
         vk::Pipeline pipeline,
         vk::PipelineLayout pipelineLayout,
         vk::DescriptorSet descriptor);
 
+    /** Rebinds set 0, with the binded PipelineLayout */
+    void bindDescriptorSet(vk::DescriptorSet descriptor);
+
     void bindBuffers(
         const Buffer& vertexBuffer,
         const Buffer& indexBuffer,
-        vk::IndexType indexType);
+        vk::IndexType indexType,
+        vk::DeviceSize vertexOffset = 0,
+        vk::DeviceSize indexOffset = 0);
 
     void setViewport(uint32_t width, uint32_t height);
 
@@ -56,12 +82,29 @@ public:
             bindedPipelineLayout_, shaderStages, pushOffset_, values);
         pushOffset_ = pushOffset_ + values.size() * sizeof(T);
     }
+    /** Pushes at offset, the sequential offset of the overload above is kept */
+    template <typename T>
+    void pushConstants(
+        vk::ShaderStageFlags shaderStages,
+        uint32_t offset,
+        vk::ArrayProxy<const T> const& values)
+    {
+        EXPENGINE_ASSERT(
+            bindedPipelineLayout_,
+            "Failed to push constants : no pipeline layout binded");
+        commandBuffer_->pushConstants(
+            bindedPipelineLayout_, shaderStages, offset, values);
+    }
 
 private:
     vk::RenderPass renderPass_;
     vk::Framebuffer framebuffer_;
     vk::Extent2D extent_;
 
+    /* GPU timestamps, optional */
+    vk::QueryPool timestampPool_;
+    uint32_t firstTimestampQuery_;
+
     /* Used during binding */
     vk::PipelineLayout bindedPipelineLayout_;
     /* Current offset of the push constants */
@@ -69,6 +112,7 @@ private:
 
     bool renderPassStarted_;
     bool renderPassEnded_;
+    vk::SubpassContents subpassContents_;
 };
 
 } // namespace vlk
@@ -0,0 +1,70 @@
+#include "VlkFrameCommandPool.hpp"
+
+#include <engine/render/vlk/VlkDebug.hpp>
+#include <engine/render/vlk/VlkDevice.hpp>
+#include <engine/render/vlk/VlkFrameCommandBuffer.hpp>
+
+namespace experim {
+namespace vlk {
+
+FrameCommandPool::FrameCommandPool(
+    const vlk::Device& device,
+    vk::RenderPass renderPass,
+    vk::Framebuffer framebuffer,
+    vk::Extent2D extent)
+    : device_(device)
+    , renderPass_(renderPass)
+    , framebuffer_(framebuffer)
+    , extent_(extent)
+{
+    /* Buffers are only reset all at once, with the pool */
+    auto [cmdPoolResult, commandPool]
+        = device_.deviceHandle().createCommandPoolUnique(
+            {.queueFamilyIndex = device_.queueIndices().graphicsFamily.value()});
+    EXPENGINE_VK_ASSERT(cmdPoolResult, "Failed to create a command pool");
+    commandPool_ = std::move(commandPool);
+}
+
+FrameCommandPool::~FrameCommandPool()
+{
+    /* The command buffers must be freed before their pool */
+    primary_.buffers.clear();
+    secondary_.buffers.clear();
+}
+
+void FrameCommandPool::reset(vk::Framebuffer framebuffer)
+{
+    auto res = device_.deviceHandle().resetCommandPool(commandPool_.get(), {});
+    EXPENGINE_VK_ASSERT(res, "Failed to reset a command pool");
+
+    framebuffer_ = framebuffer;
+    for (auto list : {&primary_, &secondary_})
+    {
+        for (size_t i = 0; i < list->buffers.size(); i++)
+        {
+            if (i < list->usedCount)
+                list->buffers[i]->reset();
+            list->buffers[i]->setFramebuffer(framebuffer);
+        }
+        list->usedCount = 0;
+    }
+}
+
+FrameCommandBuffer& FrameCommandPool::request(vk::CommandBufferLevel level)
+{
+    auto& list = level == vk::CommandBufferLevel::ePrimary ? primary_ : secondary_;
+    if (list.usedCount == list.buffers.size())
+    {
+        list.buffers.push_back(std::make_unique<FrameCommandBuffer>(
+            device_,
+            commandPool_.get(),
+            renderPass_,
+            framebuffer_,
+            extent_,
+            level));
+    }
+    return *list.buffers[list.usedCount++];
+}
+
+} // namespace vlk
+} // namespace experim
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <engine/render/vlk/VlkInclude.hpp>
+
+namespace experim {
+namespace vlk {
+
+class Device;
+class FrameCommandBuffer;
+
+/**
+ * Command pool of a frame in flight. Its command buffers are allocated once and
+ * recycled after each reset : steady-state frames allocate no Vulkan object.
+ *
+ * Externally synchronized, like the underlying vk::CommandPool.
+ */
+class FrameCommandPool {
+public:
+    FrameCommandPool(
+        const vlk::Device& device,
+        vk::RenderPass renderPass,
+        vk::Framebuffer framebuffer,
+        vk::Extent2D extent);
+    ~FrameCommandPool();
+
+    FrameCommandPool(const FrameCommandPool&) = delete;
+    FrameCommandPool& operator=(const FrameCommandPool&) = delete;
+
+    inline vk::CommandPool handle() const { return commandPool_.get(); };
+    /** Command buffers owned by the pool, used or not */
+    inline size_t allocatedCount() const
+    {
+        return primary_.buffers.size() + secondary_.buffers.size();
+    };
+
+    /** Resets the Vulkan pool : every command buffer becomes available again. The
+     * previous submissions of the pool must be complete. The render passes of the
+     * next command buffers target framebuffer. */
+    void reset(vk::Framebuffer framebuffer);
+    /** Returns an unused command buffer, not begun. Only allocates when every
+     * command buffer of this level is in use. */
+    FrameCommandBuffer& request(
+        vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary);
+
+private:
+    struct CommandBufferList {
+        std::vector<std::unique_ptr<FrameCommandBuffer>> buffers;
+        /* Buffers past usedCount are the free list */
+        size_t usedCount = 0;
+    };
+
+    /* References */
+    const vlk::Device& device_;
+
+    /* Owned objects */
+    vk::UniqueCommandPool commandPool_;
+    CommandBufferList primary_;
+    CommandBufferList secondary_;
+
+    /* Target of the recorded render passes */
+    vk::RenderPass renderPass_;
+    vk::Framebuffer framebuffer_;
+    vk::Extent2D extent_;
+};
+
+} // namespace vlk
+} // namespace experim
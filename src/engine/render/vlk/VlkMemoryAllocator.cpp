@@ -105,6 +105,16 @@ std::unique_ptr<vlk::Buffer> MemoryAllocator::createVertexBuffer(
     return std::move(vertexBuffer);
 }
 
+std::unique_ptr<vlk::Buffer> MemoryAllocator::createGeometryBuffer(
+    vk::DeviceSize size) const
+{
+    return createBuffer(
+        size,
+        VMA_MEMORY_USAGE_CPU_TO_GPU,
+        vk::BufferUsageFlagBits::eVertexBuffer
+            | vk::BufferUsageFlagBits::eIndexBuffer);
+}
+
 std::unique_ptr<vlk::Buffer> MemoryAllocator::createStagingBuffer(
     vk::DeviceSize size,
     void const* dataToCopy) const
@@ -44,6 +44,9 @@ public:
         vk::DeviceSize size,
         void const* dataToCopy = nullptr) const;
 
+    /** Host visible buffer holding both vertices and indices */
+    std::unique_ptr<vlk::Buffer> createGeometryBuffer(vk::DeviceSize size) const;
+
     std::unique_ptr<vlk::Buffer> createStagingBuffer(
         vk::DeviceSize size,
         void const* dataToCopy = nullptr) const;
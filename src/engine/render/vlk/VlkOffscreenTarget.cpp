@@ -0,0 +1,150 @@
+#include "VlkOffscreenTarget.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+#include <engine/log/ExpengineLog.hpp>
+#include <engine/render/vlk/VlkCommandBuffer.hpp>
+#include <engine/render/vlk/VlkDebug.hpp>
+#include <engine/render/vlk/VlkDevice.hpp>
+#include <engine/render/vlk/resources/VlkBuffer.hpp>
+#include <engine/render/vlk/resources/VlkImage.hpp>
+
+namespace {
+
+/* 8 bits per channel, in the byte order of the PPM format */
+const vk::SurfaceFormatKHR OFFSCREEN_FORMAT
+    = {.format = vk::Format::eR8G8B8A8Unorm,
+       .colorSpace = vk::ColorSpaceKHR::eSrgbNonlinear};
+const uint32_t OFFSCREEN_BYTES_PER_PIXEL = 4;
+
+} // namespace
+
+namespace experim {
+namespace vlk {
+
+OffscreenTarget::OffscreenTarget(
+    const vlk::Device& device,
+    vk::Extent2D requestedExtent,
+    uint32_t imageCount)
+    : device_(device)
+    , surfaceFormat_(OFFSCREEN_FORMAT)
+    , requestedExtent_(requestedExtent)
+    , nextImageIndex_(0)
+    , logger_(spdlog::get(LOGGER_NAME))
+{
+    /* No surface to constrain the extent, only avoid empty images */
+    imageExtent_ = vk::Extent2D {
+        .width = std::max(1u, requestedExtent.width),
+        .height = std::max(1u, requestedExtent.height)};
+
+    for (uint32_t i = 0; i < imageCount; i++)
+    {
+        auto image = device_.allocator().createImage(
+            VMA_MEMORY_USAGE_GPU_ONLY,
+            vk::ImageUsageFlagBits::eColorAttachment
+                | vk::ImageUsageFlagBits::eTransferSrc
+                | vk::ImageUsageFlagBits::eTransferDst,
+            surfaceFormat_.format,
+            imageExtent_.width,
+            imageExtent_.height);
+        imageHandles_.push_back(image->getHandle());
+        images_.push_back(std::move(image));
+    }
+    readbackBuffers_.resize(imageCount);
+
+    SPDLOG_LOGGER_DEBUG(
+        logger_,
+        "OffscreenTarget created : {} image(s) of {}x{}",
+        imageCount,
+        imageExtent_.width,
+        imageExtent_.height);
+}
+
+OffscreenTarget::~OffscreenTarget()
+{
+    SPDLOG_LOGGER_DEBUG(logger_, "OffscreenTarget destruction");
+}
+
+uint32_t OffscreenTarget::acquireNextImage()
+{
+    uint32_t imageIndex = nextImageIndex_;
+    nextImageIndex_ = (nextImageIndex_ + 1) % getImageCount();
+    return imageIndex;
+}
+
+void OffscreenTarget::recordReadback(
+    CommandBuffer& commandBuffer,
+    uint32_t imageIndex)
+{
+    auto& readbackBuffer = readbackBuffers_.at(imageIndex);
+    if (!readbackBuffer)
+    {
+        readbackBuffer = device_.allocator().createBuffer(
+            imageExtent_.width * imageExtent_.height * OFFSCREEN_BYTES_PER_PIXEL,
+            VMA_MEMORY_USAGE_GPU_TO_CPU,
+            vk::BufferUsageFlagBits::eTransferDst);
+    }
+
+    /* The render pass external dependency does not cover transfer reads */
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eColorAttachmentOutput,
+        vk::PipelineStageFlagBits::eTransfer,
+        {.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite,
+         .dstAccessMask = vk::AccessFlagBits::eTransferRead});
+
+    vk::BufferImageCopy region {
+        .bufferOffset = 0,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource
+        = {.aspectMask = vk::ImageAspectFlagBits::eColor,
+           .mipLevel = 0,
+           .baseArrayLayer = 0,
+           .layerCount = 1},
+        .imageOffset = {0, 0, 0},
+        .imageExtent = {imageExtent_.width, imageExtent_.height, 1}};
+    commandBuffer.copyImageToBuffer(
+        imageHandles_.at(imageIndex), readbackBuffer->getHandle(), region);
+
+    /* Make the copy visible to the host once the frame is complete */
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eHost,
+        {.srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+         .dstAccessMask = vk::AccessFlagBits::eHostRead});
+}
+
+void OffscreenTarget::writeReadback(uint32_t imageIndex, const std::string& filePath)
+{
+    auto& readbackBuffer = readbackBuffers_.at(imageIndex);
+    EXPENGINE_ASSERT(readbackBuffer, "No readback recorded for this image");
+
+    readbackBuffer->assertMap();
+    readbackBuffer->assertInvalidate();
+    auto pixels = static_cast<const uint8_t*>(readbackBuffer->mappedData());
+
+    std::ofstream file(filePath, std::ios::out | std::ios::binary);
+    if (!file)
+    {
+        SPDLOG_LOGGER_WARN(logger_, "Failed to open readback file : {}", filePath);
+    }
+    else
+    {
+        file << "P6\n"
+             << imageExtent_.width << " " << imageExtent_.height << "\n255\n";
+        const size_t pixelCount = imageExtent_.width * imageExtent_.height;
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            /* Drop the alpha channel */
+            file.write(
+                reinterpret_cast<const char*>(&pixels[i * OFFSCREEN_BYTES_PER_PIXEL]),
+                3);
+        }
+    }
+
+    readbackBuffer->unmap();
+}
+
+} // namespace vlk
+} // namespace experim
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <engine/render/vlk/VlkInclude.hpp>
+
+namespace spdlog {
+class logger;
+}
+
+namespace experim {
+namespace vlk {
+
+class Device;
+class Buffer;
+class CommandBuffer;
+class VlkImage;
+
+/** Replaces the swapchain of a headless RenderingContext : the frames are rendered
+ * into device images allocated with VMA, used in turn. Each image can be copied to
+ * a host readable buffer and written to disk once its frame is done. */
+class OffscreenTarget {
+public:
+    OffscreenTarget(
+        const vlk::Device& device,
+        vk::Extent2D requestedExtent,
+        uint32_t imageCount);
+    ~OffscreenTarget();
+
+    inline const vk::Extent2D& getImageExtent() const { return imageExtent_; }
+    inline const vk::Extent2D& getRequestedExtent() const
+    {
+        return requestedExtent_;
+    }
+    inline const vk::SurfaceFormatKHR& getSurfaceFormat() const
+    {
+        return surfaceFormat_;
+    }
+    inline const uint32_t getImageCount() const
+    {
+        return static_cast<uint32_t>(images_.size());
+    }
+    inline const std::vector<vk::Image>& getImages() const { return imageHandles_; }
+
+    /** Images are used in turn. Never blocks : the caller waits on the fence of the
+     * frame using the image. */
+    uint32_t acquireNextImage();
+
+    /** Records the copy of the image (in TransferSrcOptimal layout, after the
+     * render pass) to its readback buffer. */
+    void recordReadback(CommandBuffer& commandBuffer, uint32_t imageIndex);
+    /** Writes the readback buffer of the image to a binary PPM file. The frame
+     * which recorded the readback must be complete. */
+    void writeReadback(uint32_t imageIndex, const std::string& filePath);
+
+private:
+    /* References */
+    const vlk::Device& device_;
+
+    /* Properties */
+    vk::SurfaceFormatKHR surfaceFormat_;
+    vk::Extent2D imageExtent_;
+    /* May differ from imageExtent_, which can't be empty */
+    vk::Extent2D requestedExtent_;
+    uint32_t nextImageIndex_;
+
+    /* Owned objects */
+    std::vector<std::unique_ptr<VlkImage>> images_;
+    std::vector<vk::Image> imageHandles_;
+    /* Created on first use */
+    std::vector<std::unique_ptr<Buffer>> readbackBuffers_;
+
+    /* Logging */
+    std::shared_ptr<spdlog::logger> logger_;
+};
+
+} // namespace vlk
+} // namespace experim
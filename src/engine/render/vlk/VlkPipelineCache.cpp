@@ -0,0 +1,178 @@
+#include "VlkPipelineCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include <engine/log/ExpengineLog.hpp>
+#include <engine/render/vlk/VlkDebug.hpp>
+#include <engine/render/vlk/VlkDevice.hpp>
+#include <engine/utils/Timer.hpp>
+
+namespace {
+
+/* Layout of VK_PIPELINE_CACHE_HEADER_VERSION_ONE, at the start of the cache data */
+struct PipelineCacheHeader {
+    uint32_t headerSize;
+    uint32_t headerVersion;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+};
+
+} // namespace
+
+namespace experim {
+namespace vlk {
+
+PipelineCache::PipelineCache(
+    const vlk::Device& device,
+    const std::string& filePath,
+    std::shared_ptr<spdlog::logger> logger)
+    : device_(device)
+    , filePath_(filePath)
+    , logger_(logger)
+{
+    auto initialData = loadCompatibleData();
+    statistics_.loadedBytes = initialData.size();
+
+    auto [result, pipelineCache] = device_.deviceHandle().createPipelineCacheUnique(
+        {.initialDataSize = initialData.size(),
+         .pInitialData = initialData.empty() ? nullptr : initialData.data()});
+    EXPENGINE_VK_ASSERT(result, "Failed to create the pipeline cache");
+    pipelineCache_ = std::move(pipelineCache);
+}
+
+PipelineCache::~PipelineCache()
+{
+    auto stats = statistics();
+    SPDLOG_LOGGER_DEBUG(
+        logger_,
+        "Pipeline cache : {} pipeline(s) created in {:.2f} ms (max {:.2f} ms), {} "
+        "bytes loaded at startup",
+        stats.createdPipelines,
+        stats.totalCreationTime,
+        stats.maxCreationTime,
+        stats.loadedBytes);
+    save();
+}
+
+vk::UniquePipeline PipelineCache::createGraphicsPipeline(
+    const vk::GraphicsPipelineCreateInfo& pipelineInfo)
+{
+    Timer creationTimer;
+    auto [result, pipeline] = device_.deviceHandle().createGraphicsPipelineUnique(
+        pipelineCache_.get(), pipelineInfo);
+    EXPENGINE_VK_ASSERT(result, "Failed to create a graphics pipeline");
+    const double creationTime = creationTimer.getElapsedTime();
+
+    {
+        std::lock_guard<std::mutex> lock(statisticsMutex_);
+        statistics_.createdPipelines++;
+        statistics_.totalCreationTime += creationTime;
+        statistics_.maxCreationTime
+            = std::max(statistics_.maxCreationTime, creationTime);
+    }
+    SPDLOG_LOGGER_DEBUG(
+        logger_, "Graphics pipeline created in {:.3f} ms", creationTime);
+
+    return std::move(pipeline);
+}
+
+PipelineCacheStatistics PipelineCache::statistics() const
+{
+    std::lock_guard<std::mutex> lock(statisticsMutex_);
+    return statistics_;
+}
+
+bool PipelineCache::save() const
+{
+    if (filePath_.empty())
+        return false;
+
+    auto [result, data]
+        = device_.deviceHandle().getPipelineCacheData(pipelineCache_.get());
+    if (result != vk::Result::eSuccess)
+    {
+        SPDLOG_LOGGER_WARN(logger_, "Failed to get the pipeline cache data");
+        return false;
+    }
+
+    /* Written next to the file then renamed : a crash while saving can't leave a
+     * truncated cache behind */
+    const std::string tmpPath = filePath_ + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()
+            || !file.write(reinterpret_cast<const char*>(data.data()), data.size()))
+        {
+            SPDLOG_LOGGER_WARN(
+                logger_, "Failed to write the pipeline cache {}", tmpPath);
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tmpPath, filePath_, error);
+    if (error)
+    {
+        SPDLOG_LOGGER_WARN(
+            logger_, "Failed to save the pipeline cache : {}", error.message());
+        return false;
+    }
+
+    SPDLOG_LOGGER_DEBUG(
+        logger_, "Pipeline cache saved to {} ({} bytes)", filePath_, data.size());
+    return true;
+}
+
+std::vector<char> PipelineCache::loadCompatibleData() const
+{
+    if (filePath_.empty())
+        return {};
+
+    std::ifstream file(filePath_, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        SPDLOG_LOGGER_INFO(logger_, "No pipeline cache found, cold start");
+        return {};
+    }
+    std::vector<char> data(
+        (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    PipelineCacheHeader header;
+    if (data.size() < sizeof(header))
+    {
+        SPDLOG_LOGGER_WARN(logger_, "Invalid pipeline cache {}, ignored", filePath_);
+        return {};
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    const auto& properties = device_.properties();
+    if (header.headerSize < sizeof(header) || header.headerSize > data.size()
+        || header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+    {
+        SPDLOG_LOGGER_WARN(logger_, "Invalid pipeline cache {}, ignored", filePath_);
+        return {};
+    }
+    if (header.vendorID != properties.vendorID
+        || header.deviceID != properties.deviceID
+        || std::memcmp(
+               header.pipelineCacheUUID,
+               properties.pipelineCacheUUID.data(),
+               VK_UUID_SIZE)
+            != 0)
+    {
+        SPDLOG_LOGGER_INFO(
+            logger_, "Pipeline cache written by another device or driver, ignored");
+        return {};
+    }
+
+    SPDLOG_LOGGER_INFO(
+        logger_, "Pipeline cache loaded from {} ({} bytes)", filePath_, data.size());
+    return data;
+}
+
+} // namespace vlk
+} // namespace experim
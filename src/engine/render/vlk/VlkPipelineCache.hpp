@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <engine/render/vlk/VlkInclude.hpp>
+
+namespace spdlog {
+class logger;
+}
+
+namespace experim {
+namespace vlk {
+
+class Device;
+
+struct PipelineCacheStatistics {
+    /** @brief Size of the cache data loaded from disk, 0 on a cold start. */
+    size_t loadedBytes = 0;
+    /** @brief Pipelines created since startup. */
+    uint32_t createdPipelines = 0;
+    /** @brief Total and worst creation times, in ms. A warm cache mostly shows in
+     * these. */
+    double totalCreationTime = 0.0;
+    double maxCreationTime = 0.0;
+};
+
+/**
+ * Device-level VkPipelineCache, used for every pipeline creation. Loaded from
+ * filePath on creation and saved back on destruction. The data on disk is only
+ * used if its header matches the device : vendor, device and pipeline cache UUID
+ * (which changes with the driver build).
+ */
+class PipelineCache {
+public:
+    /** An empty filePath disables the persistence */
+    PipelineCache(
+        const vlk::Device& device,
+        const std::string& filePath,
+        std::shared_ptr<spdlog::logger> logger);
+    ~PipelineCache();
+
+    inline vk::PipelineCache handle() const { return pipelineCache_.get(); };
+
+    /** Thread-safe */
+    vk::UniquePipeline createGraphicsPipeline(
+        const vk::GraphicsPipelineCreateInfo& pipelineInfo);
+
+    PipelineCacheStatistics statistics() const;
+    /** Writes the cache data to the file. Returns false on failure. */
+    bool save() const;
+
+private:
+    /* References */
+    const vlk::Device& device_;
+
+    /* Owned objects */
+    vk::UniquePipelineCache pipelineCache_;
+
+    /* Configuration */
+    const std::string filePath_;
+
+    /* Statistics */
+    mutable std::mutex statisticsMutex_;
+    PipelineCacheStatistics statistics_;
+
+    /* Logging */
+    std::shared_ptr<spdlog::logger> logger_;
+
+    /** Empty if the file does not exist or was written for another device or
+     * driver */
+    std::vector<char> loadCompatibleData() const;
+};
+
+} // namespace vlk
+} // namespace experim
@@ -0,0 +1,360 @@
+#include "VlkPipelineRegistry.hpp"
+
+#include <functional>
+#include <string_view>
+#include <type_traits>
+
+#include <engine/log/ExpengineLog.hpp>
+#include <engine/render/vlk/VlkDevice.hpp>
+#include <engine/render/vlk/VlkPipelineCache.hpp>
+
+namespace {
+
+template <typename T> void hashCombine(size_t& seed, const T& value)
+{
+    seed ^= std::hash<T> {}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+template <typename BitType>
+void hashCombine(size_t& seed, const vk::Flags<BitType>& flags)
+{
+    hashCombine(seed, static_cast<typename vk::Flags<BitType>::MaskType>(flags));
+}
+
+/* Appends values to a byte string. Fields are written one by one : the padding of
+ * the structures is not part of the state. */
+class StateWriter {
+public:
+    template <typename T> void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        data_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    template <typename BitType> void write(const vk::Flags<BitType>& flags)
+    {
+        write(static_cast<typename vk::Flags<BitType>::MaskType>(flags));
+    }
+    /* Prefixed by their size, so that consecutive strings can't be confused */
+    void writeBytes(const void* bytes, size_t size)
+    {
+        write(size);
+        data_.append(static_cast<const char*>(bytes), size);
+    }
+    void writeString(std::string_view str) { writeBytes(str.data(), str.size()); }
+
+    std::string take() { return std::move(data_); }
+
+private:
+    std::string data_;
+};
+
+void writeStencilOp(StateWriter& writer, const vk::StencilOpState& stencilOp)
+{
+    writer.write(stencilOp.failOp);
+    writer.write(stencilOp.passOp);
+    writer.write(stencilOp.depthFailOp);
+    writer.write(stencilOp.compareOp);
+    writer.write(stencilOp.compareMask);
+    writer.write(stencilOp.writeMask);
+    writer.write(stencilOp.reference);
+}
+
+bool isDynamic(
+    const vk::GraphicsPipelineCreateInfo& pipelineInfo,
+    vk::DynamicState state)
+{
+    const auto* dynamicState = pipelineInfo.pDynamicState;
+    if (!dynamicState)
+        return false;
+    for (uint32_t i = 0; i < dynamicState->dynamicStateCount; i++)
+    {
+        if (dynamicState->pDynamicStates[i] == state)
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
+namespace experim {
+namespace vlk {
+
+std::string copyGraphicsPipelineState(
+    const vk::GraphicsPipelineCreateInfo& pipelineInfo)
+{
+    EXPENGINE_ASSERT(!pipelineInfo.pNext, "Unsupported pipeline pNext chain");
+    StateWriter writer;
+
+    writer.write(pipelineInfo.flags);
+    writer.write(pipelineInfo.stageCount);
+    for (uint32_t i = 0; i < pipelineInfo.stageCount; i++)
+    {
+        const auto& stage = pipelineInfo.pStages[i];
+        EXPENGINE_ASSERT(!stage.pNext, "Unsupported shader stage pNext chain");
+        writer.write(stage.flags);
+        writer.write(stage.stage);
+        writer.write(static_cast<VkShaderModule>(stage.module));
+        writer.writeString(stage.pName);
+
+        const auto* specialization = stage.pSpecializationInfo;
+        writer.write(specialization != nullptr);
+        if (specialization)
+        {
+            writer.write(specialization->mapEntryCount);
+            for (uint32_t j = 0; j < specialization->mapEntryCount; j++)
+            {
+                const auto& entry = specialization->pMapEntries[j];
+                writer.write(entry.constantID);
+                writer.write(entry.offset);
+                writer.write(entry.size);
+            }
+            writer.writeBytes(specialization->pData, specialization->dataSize);
+        }
+    }
+
+    /* Absent states are written as such : an absent state and an empty one are not
+     * always equivalent */
+    const auto* vertexInput = pipelineInfo.pVertexInputState;
+    writer.write(vertexInput != nullptr);
+    if (vertexInput)
+    {
+        EXPENGINE_ASSERT(
+            !vertexInput->pNext, "Unsupported vertex input pNext chain");
+        writer.write(vertexInput->flags);
+        writer.write(vertexInput->vertexBindingDescriptionCount);
+        for (uint32_t i = 0; i < vertexInput->vertexBindingDescriptionCount; i++)
+        {
+            const auto& binding = vertexInput->pVertexBindingDescriptions[i];
+            writer.write(binding.binding);
+            writer.write(binding.stride);
+            writer.write(binding.inputRate);
+        }
+        writer.write(vertexInput->vertexAttributeDescriptionCount);
+        for (uint32_t i = 0; i < vertexInput->vertexAttributeDescriptionCount; i++)
+        {
+            const auto& attribute = vertexInput->pVertexAttributeDescriptions[i];
+            writer.write(attribute.location);
+            writer.write(attribute.binding);
+            writer.write(attribute.format);
+            writer.write(attribute.offset);
+        }
+    }
+
+    const auto* inputAssembly = pipelineInfo.pInputAssemblyState;
+    writer.write(inputAssembly != nullptr);
+    if (inputAssembly)
+    {
+        EXPENGINE_ASSERT(
+            !inputAssembly->pNext, "Unsupported input assembly pNext chain");
+        writer.write(inputAssembly->flags);
+        writer.write(inputAssembly->topology);
+        writer.write(inputAssembly->primitiveRestartEnable);
+    }
+
+    const auto* tessellation = pipelineInfo.pTessellationState;
+    writer.write(tessellation != nullptr);
+    if (tessellation)
+    {
+        EXPENGINE_ASSERT(
+            !tessellation->pNext, "Unsupported tessellation pNext chain");
+        writer.write(tessellation->flags);
+        writer.write(tessellation->patchControlPoints);
+    }
+
+    const auto* viewport = pipelineInfo.pViewportState;
+    writer.write(viewport != nullptr);
+    if (viewport)
+    {
+        EXPENGINE_ASSERT(!viewport->pNext, "Unsupported viewport pNext chain");
+        writer.write(viewport->flags);
+        writer.write(viewport->viewportCount);
+        writer.write(viewport->scissorCount);
+        /* Ignored when dynamic, and then possibly invalid */
+        if (!isDynamic(pipelineInfo, vk::DynamicState::eViewport))
+        {
+            for (uint32_t i = 0; i < viewport->viewportCount; i++)
+            {
+                const auto& staticViewport = viewport->pViewports[i];
+                writer.write(staticViewport.x);
+                writer.write(staticViewport.y);
+                writer.write(staticViewport.width);
+                writer.write(staticViewport.height);
+                writer.write(staticViewport.minDepth);
+                writer.write(staticViewport.maxDepth);
+            }
+        }
+        if (!isDynamic(pipelineInfo, vk::DynamicState::eScissor))
+        {
+            for (uint32_t i = 0; i < viewport->scissorCount; i++)
+            {
+                const auto& scissor = viewport->pScissors[i];
+                writer.write(scissor.offset.x);
+                writer.write(scissor.offset.y);
+                writer.write(scissor.extent.width);
+                writer.write(scissor.extent.height);
+            }
+        }
+    }
+
+    const auto* rasterization = pipelineInfo.pRasterizationState;
+    writer.write(rasterization != nullptr);
+    if (rasterization)
+    {
+        EXPENGINE_ASSERT(
+            !rasterization->pNext, "Unsupported rasterization pNext chain");
+        writer.write(rasterization->flags);
+        writer.write(rasterization->depthClampEnable);
+        writer.write(rasterization->rasterizerDiscardEnable);
+        writer.write(rasterization->polygonMode);
+        writer.write(rasterization->cullMode);
+        writer.write(rasterization->frontFace);
+        writer.write(rasterization->depthBiasEnable);
+        writer.write(rasterization->depthBiasConstantFactor);
+        writer.write(rasterization->depthBiasClamp);
+        writer.write(rasterization->depthBiasSlopeFactor);
+        writer.write(rasterization->lineWidth);
+    }
+
+    const auto* multisampling = pipelineInfo.pMultisampleState;
+    writer.write(multisampling != nullptr);
+    if (multisampling)
+    {
+        EXPENGINE_ASSERT(
+            !multisampling->pNext, "Unsupported multisample pNext chain");
+        writer.write(multisampling->flags);
+        writer.write(multisampling->rasterizationSamples);
+        writer.write(multisampling->sampleShadingEnable);
+        writer.write(multisampling->minSampleShading);
+        /* One 32 bits mask word per 32 samples */
+        writer.write(multisampling->pSampleMask != nullptr);
+        if (multisampling->pSampleMask)
+        {
+            const uint32_t wordCount
+                = (static_cast<uint32_t>(multisampling->rasterizationSamples) + 31)
+                / 32;
+            writer.writeBytes(
+                multisampling->pSampleMask, wordCount * sizeof(uint32_t));
+        }
+        writer.write(multisampling->alphaToCoverageEnable);
+        writer.write(multisampling->alphaToOneEnable);
+    }
+
+    const auto* depthStencil = pipelineInfo.pDepthStencilState;
+    writer.write(depthStencil != nullptr);
+    if (depthStencil)
+    {
+        EXPENGINE_ASSERT(
+            !depthStencil->pNext, "Unsupported depth stencil pNext chain");
+        writer.write(depthStencil->flags);
+        writer.write(depthStencil->depthTestEnable);
+        writer.write(depthStencil->depthWriteEnable);
+        writer.write(depthStencil->depthCompareOp);
+        writer.write(depthStencil->depthBoundsTestEnable);
+        writer.write(depthStencil->stencilTestEnable);
+        writeStencilOp(writer, depthStencil->front);
+        writeStencilOp(writer, depthStencil->back);
+        writer.write(depthStencil->minDepthBounds);
+        writer.write(depthStencil->maxDepthBounds);
+    }
+
+    const auto* colorBlend = pipelineInfo.pColorBlendState;
+    writer.write(colorBlend != nullptr);
+    if (colorBlend)
+    {
+        EXPENGINE_ASSERT(!colorBlend->pNext, "Unsupported color blend pNext chain");
+        writer.write(colorBlend->flags);
+        writer.write(colorBlend->logicOpEnable);
+        writer.write(colorBlend->logicOp);
+        writer.write(colorBlend->attachmentCount);
+        for (uint32_t i = 0; i < colorBlend->attachmentCount; i++)
+        {
+            const auto& attachment = colorBlend->pAttachments[i];
+            writer.write(attachment.blendEnable);
+            writer.write(attachment.srcColorBlendFactor);
+            writer.write(attachment.dstColorBlendFactor);
+            writer.write(attachment.colorBlendOp);
+            writer.write(attachment.srcAlphaBlendFactor);
+            writer.write(attachment.dstAlphaBlendFactor);
+            writer.write(attachment.alphaBlendOp);
+            writer.write(attachment.colorWriteMask);
+        }
+        for (float constant : colorBlend->blendConstants)
+            writer.write(constant);
+    }
+
+    const auto* dynamicState = pipelineInfo.pDynamicState;
+    writer.write(dynamicState != nullptr);
+    if (dynamicState)
+    {
+        EXPENGINE_ASSERT(
+            !dynamicState->pNext, "Unsupported dynamic state pNext chain");
+        writer.write(dynamicState->flags);
+        writer.write(dynamicState->dynamicStateCount);
+        for (uint32_t i = 0; i < dynamicState->dynamicStateCount; i++)
+            writer.write(dynamicState->pDynamicStates[i]);
+    }
+
+    writer.write(static_cast<VkPipelineLayout>(pipelineInfo.layout));
+    writer.write(pipelineInfo.subpass);
+    writer.write(static_cast<VkPipeline>(pipelineInfo.basePipelineHandle));
+    writer.write(pipelineInfo.basePipelineIndex);
+
+    return writer.take();
+}
+
+size_t PipelineRegistry::PipelineKeyHash::operator()(const PipelineKey& key) const
+{
+    size_t seed = std::hash<std::string> {}(key.state);
+    hashCombine(seed, key.compatibility.colorFormat);
+    hashCombine(seed, key.compatibility.depthFormat);
+    hashCombine(seed, key.compatibility.samples);
+    return seed;
+}
+
+PipelineRegistry::PipelineRegistry(const vlk::Device& device)
+    : device_(device)
+    , logger_(spdlog::get(LOGGER_NAME))
+{
+}
+
+PipelineRegistry::~PipelineRegistry()
+{
+    SPDLOG_LOGGER_DEBUG(
+        logger_, "PipelineRegistry destruction, {} pipeline(s)", pipelines_.size());
+}
+
+vk::Pipeline PipelineRegistry::graphicsPipeline(
+    const vk::GraphicsPipelineCreateInfo& pipelineInfo,
+    const RenderPassCompatibility& compatibility)
+{
+    PipelineKey key {
+        .state = copyGraphicsPipelineState(pipelineInfo),
+        .compatibility = compatibility};
+
+    std::lock_guard<std::mutex> lock(pipelinesMutex_);
+    auto pipelineIt = pipelines_.find(key);
+    if (pipelineIt != pipelines_.end())
+        return pipelineIt->second.get();
+
+    /* Created while holding the lock : concurrent requests of the same key must
+     * not compile it twice */
+    auto pipeline = device_.pipelineCache().createGraphicsPipeline(pipelineInfo);
+    auto pipelineHandle = pipeline.get();
+    pipelines_.emplace(std::move(key), std::move(pipeline));
+    SPDLOG_LOGGER_DEBUG(
+        logger_,
+        "Graphics pipeline created for format {}, {} pipeline(s) registered",
+        vk::to_string(compatibility.colorFormat),
+        pipelines_.size());
+
+    return pipelineHandle;
+}
+
+size_t PipelineRegistry::pipelineCount() const
+{
+    std::lock_guard<std::mutex> lock(pipelinesMutex_);
+    return pipelines_.size();
+}
+
+} // namespace vlk
+} // namespace experim
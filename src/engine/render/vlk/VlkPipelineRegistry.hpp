@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <engine/render/vlk/VlkInclude.hpp>
+
+namespace spdlog {
+class logger;
+}
+
+namespace experim {
+namespace vlk {
+
+class Device;
+
+/** What makes two single-subpass render passes compatible : a pipeline created
+ * with one can be used with the other. Layouts, load and store operations do not
+ * matter. */
+struct RenderPassCompatibility {
+    /* eUndefined when there is no such attachment */
+    vk::Format colorFormat = vk::Format::eUndefined;
+    vk::Format depthFormat = vk::Format::eUndefined;
+    vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+
+    bool operator==(const RenderPassCompatibility&) const = default;
+};
+
+/** Comparable copy of the state described by pipelineInfo, render pass excluded :
+ * the pointed arrays and strings are copied, handles are kept as is. Two infos
+ * describe the same pipeline when their copies are equal. pNext chains are not
+ * supported. */
+std::string copyGraphicsPipelineState(
+    const vk::GraphicsPipelineCreateInfo& pipelineInfo);
+
+/**
+ * Graphics pipelines shared by their users, keyed by pipeline state and render
+ * pass compatibility. A pipeline is only created on the first request of its key,
+ * through the device pipeline cache, and lives as long as the registry.
+ *
+ * Thread-safe.
+ */
+class PipelineRegistry {
+public:
+    PipelineRegistry(const vlk::Device& device);
+    ~PipelineRegistry();
+
+    /** pipelineInfo.renderPass must be set, and be described by compatibility */
+    vk::Pipeline graphicsPipeline(
+        const vk::GraphicsPipelineCreateInfo& pipelineInfo,
+        const RenderPassCompatibility& compatibility);
+
+    size_t pipelineCount() const;
+
+private:
+    /* The whole state is compared : a hash collision can't return the pipeline of
+     * another state */
+    struct PipelineKey {
+        std::string state;
+        RenderPassCompatibility compatibility;
+
+        bool operator==(const PipelineKey&) const = default;
+    };
+    struct PipelineKeyHash {
+        size_t operator()(const PipelineKey& key) const;
+    };
+
+    /* References */
+    const vlk::Device& device_;
+
+    /* Owned objects */
+    mutable std::mutex pipelinesMutex_;
+    std::unordered_map<PipelineKey, vk::UniquePipeline, PipelineKeyHash> pipelines_;
+
+    /* Logging */
+    std::shared_ptr<spdlog::logger> logger_;
+};
+
+} // namespace vlk
+} // namespace experim
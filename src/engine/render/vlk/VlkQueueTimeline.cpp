@@ -0,0 +1,206 @@
+#include "VlkQueueTimeline.hpp"
+
+#include <array>
+
+#include <engine/log/ExpengineLog.hpp>
+#include <engine/render/vlk/VlkDebug.hpp>
+#include <engine/render/vlk/VlkDevice.hpp>
+
+namespace {
+
+/* Binary semaphores signaled along the timeline by a single submission */
+const uint32_t MAX_SIGNAL_SEMAPHORES = 8;
+
+} // namespace
+
+namespace experim {
+namespace vlk {
+
+QueueTimeline::QueueTimeline(
+    const vlk::Device& device,
+    vk::Queue queue,
+    bool useTimelineSemaphore)
+    : device_(device)
+    , queue_(queue)
+    , submittedValue_(0)
+    , reachedValue_(0)
+{
+    if (!useTimelineSemaphore)
+        return;
+
+    vk::SemaphoreTypeCreateInfoKHR typeInfo {
+        .semaphoreType = vk::SemaphoreTypeKHR::eTimeline, .initialValue = 0};
+    auto [result, semaphore]
+        = device_.deviceHandle().createSemaphoreUnique({.pNext = &typeInfo});
+    EXPENGINE_VK_ASSERT(result, "Failed to create a timeline semaphore");
+    semaphore_ = std::move(semaphore);
+}
+
+QueueTimeline::~QueueTimeline()
+{
+    bool completed = wait(submittedValue());
+    EXPENGINE_ASSERT(completed, "Failed to wait for the queue submissions");
+}
+
+uint64_t QueueTimeline::submit(const vk::SubmitInfo& submitInfo)
+{
+    const uint64_t value = submittedValue_.load() + 1;
+
+    if (semaphore_)
+    {
+        /* The values of the binary semaphores are ignored */
+        const uint32_t binaryCount = submitInfo.signalSemaphoreCount;
+        EXPENGINE_ASSERT(
+            binaryCount < MAX_SIGNAL_SEMAPHORES, "Too many signal semaphores");
+        std::array<vk::Semaphore, MAX_SIGNAL_SEMAPHORES> signalSemaphores;
+        std::array<uint64_t, MAX_SIGNAL_SEMAPHORES> signalValues {};
+        for (uint32_t i = 0; i < binaryCount; i++)
+        {
+            signalSemaphores[i] = submitInfo.pSignalSemaphores[i];
+        }
+        signalSemaphores[binaryCount] = semaphore_.get();
+        signalValues[binaryCount] = value;
+
+        vk::TimelineSemaphoreSubmitInfoKHR timelineInfo {
+            .signalSemaphoreValueCount = binaryCount + 1,
+            .pSignalSemaphoreValues = signalValues.data()};
+        vk::SubmitInfo timelineSubmitInfo = submitInfo;
+        timelineSubmitInfo.pNext = &timelineInfo;
+        timelineSubmitInfo.signalSemaphoreCount = binaryCount + 1;
+        timelineSubmitInfo.pSignalSemaphores = signalSemaphores.data();
+
+        auto res = queue_.submit(timelineSubmitInfo, nullptr);
+        EXPENGINE_VK_ASSERT(res, "Failed to submit to the queue");
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(fencesMutex_);
+        auto fence = acquireFence();
+        auto res = queue_.submit(submitInfo, fence.get());
+        EXPENGINE_VK_ASSERT(res, "Failed to submit to the queue");
+        pendingFences_.push_back(
+            {.value = value, .fence = std::move(fence), .waiterCount = 0});
+    }
+
+    submittedValue_.store(value);
+    return value;
+}
+
+bool QueueTimeline::isReached(uint64_t value)
+{
+    if (value <= reachedValue_.load())
+        return true;
+
+    if (semaphore_)
+    {
+        auto [result, counter]
+            = device_.deviceHandle().getSemaphoreCounterValueKHR(semaphore_.get());
+        EXPENGINE_VK_ASSERT(result, "Failed to read a timeline semaphore");
+        updateReachedValue(counter);
+        return value <= counter;
+    }
+
+    std::lock_guard<std::mutex> lock(fencesMutex_);
+    collectReachedFences();
+    return value <= reachedValue_.load();
+}
+
+bool QueueTimeline::wait(uint64_t value, uint64_t timeoutNanosec)
+{
+    EXPENGINE_ASSERT(value <= submittedValue(), "Waiting on an unsubmitted value");
+    if (value <= reachedValue_.load())
+        return true;
+
+    if (semaphore_)
+    {
+        auto semaphore = semaphore_.get();
+        auto res = device_.deviceHandle().waitSemaphoresKHR(
+            {.semaphoreCount = 1, .pSemaphores = &semaphore, .pValues = &value},
+            timeoutNanosec);
+        if (res == vk::Result::eTimeout)
+            return false;
+        EXPENGINE_VK_ASSERT(res, "Failed to wait on a timeline semaphore");
+        updateReachedValue(value);
+        return true;
+    }
+
+    /* Not held during the wait, so that isReached and the submissions of the other
+     * threads are not blocked. Pending fences are only removed from the front : the
+     * waited one stays in place, and is not recycled while it has waiters. */
+    PendingFence* waited = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(fencesMutex_);
+        collectReachedFences();
+        for (auto& pending : pendingFences_)
+        {
+            /* Values are consecutive : the first pending one not below value is
+             * the fence of its submission */
+            if (pending.value < value)
+                continue;
+            waited = &pending;
+            waited->waiterCount++;
+            break;
+        }
+    }
+    if (!waited)
+        return true;
+
+    auto res = device_.deviceHandle().waitForFences(
+        waited->fence.get(), VK_TRUE, timeoutNanosec);
+
+    std::lock_guard<std::mutex> lock(fencesMutex_);
+    waited->waiterCount--;
+    if (res == vk::Result::eTimeout)
+        return false;
+    EXPENGINE_VK_ASSERT(res, "Failed to wait on a fence");
+    updateReachedValue(value);
+    collectReachedFences();
+    return true;
+}
+
+void QueueTimeline::updateReachedValue(uint64_t value)
+{
+    uint64_t reached = reachedValue_.load();
+    while (reached < value && !reachedValue_.compare_exchange_weak(reached, value))
+    {
+    }
+}
+
+vk::UniqueFence QueueTimeline::acquireFence()
+{
+    collectReachedFences();
+    if (!freeFences_.empty())
+    {
+        auto fence = std::move(freeFences_.back());
+        freeFences_.pop_back();
+        return fence;
+    }
+
+    auto [result, fence] = device_.deviceHandle().createFenceUnique({});
+    EXPENGINE_VK_ASSERT(result, "Failed to create a fence");
+    return std::move(fence);
+}
+
+void QueueTimeline::collectReachedFences()
+{
+    /* A fence is signaled after all the previous submissions to the queue */
+    while (!pendingFences_.empty()
+           && device_.deviceHandle().getFenceStatus(
+                  pendingFences_.front().fence.get())
+               == vk::Result::eSuccess)
+    {
+        auto& pending = pendingFences_.front();
+        updateReachedValue(pending.value);
+        /* Recycled by the next call, once its waiters are done */
+        if (pending.waiterCount > 0)
+            break;
+
+        auto res = device_.deviceHandle().resetFences(pending.fence.get());
+        EXPENGINE_VK_ASSERT(res, "Failed to reset a fence");
+        freeFences_.push_back(std::move(pending.fence));
+        pendingFences_.pop_front();
+    }
+}
+
+} // namespace vlk
+} // namespace experim
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <engine/render/vlk/VlkInclude.hpp>
+
+namespace experim {
+namespace vlk {
+
+class Device;
+
+/**
+ * Completion of the submissions to a queue, as a monotonically increasing value :
+ * each submission signals the next value, and reaching a value means that every
+ * submission up to it is complete. Value 0 is always reached.
+ *
+ * With timeline semaphores (VK_KHR_timeline_semaphore), a single semaphore tracks
+ * all the submissions, and polling is a counter read. Otherwise, each submission
+ * signals a fence, recycled once reached.
+ *
+ * Thread-safe. Submissions must also hold Device::queueMutex().
+ */
+class QueueTimeline {
+public:
+    QueueTimeline(
+        const vlk::Device& device,
+        vk::Queue queue,
+        bool useTimelineSemaphore);
+    /** Waits for the submitted values */
+    ~QueueTimeline();
+
+    QueueTimeline(const QueueTimeline&) = delete;
+    QueueTimeline& operator=(const QueueTimeline&) = delete;
+
+    inline bool usesTimelineSemaphore() const { return bool(semaphore_); };
+    /** Value signaled by the latest submission */
+    inline uint64_t submittedValue() const { return submittedValue_.load(); };
+
+    /** Submits submitInfo to the queue, and returns the value reached once it is
+     * complete. Device::queueMutex() must be held. submitInfo must not have a pNext
+     * chain. */
+    uint64_t submit(const vk::SubmitInfo& submitInfo);
+
+    /** Non-blocking */
+    bool isReached(uint64_t value);
+    /** Returns false on timeout */
+    bool wait(uint64_t value, uint64_t timeoutNanosec = UINT64_MAX);
+
+private:
+    struct PendingFence {
+        uint64_t value;
+        vk::UniqueFence fence;
+        /* Threads waiting on the fence outside of fencesMutex_ : it is not
+         * recycled until they are done */
+        uint32_t waiterCount;
+    };
+
+    /* References */
+    const vlk::Device& device_;
+    vk::Queue queue_;
+
+    /* Owned objects */
+    /* Null without timeline semaphores support */
+    vk::UniqueSemaphore semaphore_;
+    /* Fences fallback */
+    std::mutex fencesMutex_;
+    /* Submission order */
+    std::deque<PendingFence> pendingFences_;
+    std::vector<vk::UniqueFence> freeFences_;
+
+    /* Values */
+    std::atomic<uint64_t> submittedValue_;
+    /* Latest value known to be reached, saves the queries of older values */
+    std::atomic<uint64_t> reachedValue_;
+
+    void updateReachedValue(uint64_t value);
+    /* Must be called with fencesMutex_ held */
+    vk::UniqueFence acquireFence();
+    void collectReachedFences();
+};
+
+} // namespace vlk
+} // namespace experim
@@ -3,18 +3,41 @@
 #include <random>
 #include <stdexcept>
 
+#include <SDL2/SDL_filesystem.h>
+
 #include <ExperimEngineConfig.h>
+#include <engine/render/HeadlessWindow.hpp>
+#include <engine/render/RenderThread.hpp>
 #include <engine/render/imgui/ImGuiBackend.hpp>
+#include <engine/render/imgui/ImGuiFramePacket.hpp>
 #include <engine/render/resources/Texture.hpp>
 #include <engine/render/vlk/VlkCapabilities.hpp>
 #include <engine/render/vlk/VlkDebug.hpp>
+#include <engine/render/vlk/VlkDeletionQueue.hpp>
 #include <engine/render/vlk/VlkDispatch.hpp>
 #include <engine/render/vlk/VlkRenderingContext.hpp>
+#include <engine/render/vlk/VlkUploader.hpp>
 #include <engine/render/vlk/VlkWindow.hpp>
+#include <engine/utils/Timer.hpp>
 
 namespace {
+
+const std::string PIPELINE_CACHE_FILENAME = "vk_pipeline_cache.bin";
+
+/* In the per-user writable directory of the application. Empty (no persistence)
+ * if there is none. */
+std::string getPipelineCachePath(const std::string& appName)
+{
+    char* prefPath = SDL_GetPrefPath(EXPERIMENGINE_NAME, appName.c_str());
+    if (prefPath == nullptr)
+        return "";
+    std::string path = std::string(prefPath) + PIPELINE_CACHE_FILENAME;
+    SDL_free(prefPath);
+    return path;
 }
 
+} // namespace
+
 namespace experim {
 namespace vlk {
 
@@ -23,26 +46,63 @@ VulkanRenderer::VulkanRenderer(
     const uint32_t appVersion,
     int windowWidth,
     int windoHeight,
-    EngineParameters& engineParams)
+    EngineParameters& engineParams,
+    JobSystem& jobSystem,
+    bool headless)
     : Renderer(engineParams)
+    , jobSystem_(jobSystem)
+    , framePacketIndex_(0)
 {
-    mainWindow_
-        = std::make_shared<vlk::VulkanWindow>(windowWidth, windoHeight, appName);
+    std::shared_ptr<vlk::VulkanWindow> vulkanWindow;
+    std::shared_ptr<HeadlessWindow> headlessWindow;
+    if (headless)
+    {
+        headlessWindow = std::make_shared<HeadlessWindow>(windowWidth, windoHeight);
+        mainWindow_ = headlessWindow;
+    }
+    else
+    {
+        vulkanWindow = std::make_shared<vlk::VulkanWindow>(
+            windowWidth, windoHeight, appName);
+        mainWindow_ = vulkanWindow;
+    }
 
     vk::DispatchLoaderDynamic& dispatchLoader_ = vlk::initializeDispatch();
-    vkInstance_ = createVulkanInstance(appName, appVersion, *mainWindow_);
+    /* No surface extension required when headless */
+    vkInstance_ = createVulkanInstance(
+        appName,
+        appVersion,
+        headless ? std::vector<const char*> {}
+                 : vulkanWindow->getRequiredVkExtensions());
     vlk::initializeInstanceDispatch(*vkInstance_, dispatchLoader_);
 
     vkDebugMessenger_
         = setupDebugMessenger(*vkInstance_, vlk::ENABLE_VALIDATION_LAYERS);
 
-    vlkDevice_
-        = std::make_unique<vlk::Device>(*vkInstance_, dispatchLoader_, logger_);
+    vlkDevice_ = std::make_unique<vlk::Device>(
+        *vkInstance_,
+        dispatchLoader_,
+        logger_,
+        headless,
+        getPipelineCachePath(appName));
     /* Only 1 device for now */
     vlk::specializeDeviceDispatch(*vlkDevice_, dispatchLoader_);
 
-    mainRenderingContext_ = std::make_shared<VulkanRenderingContext>(
-        *vlkDevice_, mainWindow_, AttachmentsFlagBits::eColorAttachment);
+    if (headless)
+    {
+        mainRenderingContext_ = std::make_shared<VulkanRenderingContext>(
+            *vlkDevice_, headlessWindow, AttachmentsFlagBits::eColorAttachment);
+    }
+    else
+    {
+        mainRenderingContext_ = std::make_shared<VulkanRenderingContext>(
+            *vlkDevice_,
+            vulkanWindow,
+            AttachmentsFlagBits::eColorAttachment,
+            DEFAULT_FRAMES_IN_FLIGHT,
+            engineParams_.graphicSettings);
+    }
+    engineParams_.presentation = mainRenderingContext_->presentation();
 
     imguiBackend_
         = std::make_unique<ImguiBackend>(*this, mainRenderingContext_, mainWindow_);
@@ -51,6 +111,8 @@ VulkanRenderer::VulkanRenderer(
 VulkanRenderer::~VulkanRenderer()
 {
     SPDLOG_LOGGER_DEBUG(logger_, "Vulkan renderer destruction");
+    /* Finish the frame in flight before destroying what it uses */
+    renderThread_.reset();
     if (vlk::ENABLE_VALIDATION_LAYERS)
     {
         vlk::destroyDebugUtilsMessengerEXT(*vkInstance_, vkDebugMessenger_);
@@ -61,15 +123,145 @@ void VulkanRenderer::prepareFrame() { imguiBackend_->prepareFrame(); }
 
 void VulkanRenderer::renderFrame()
 {
+    /* Reclaim the staging memory of the executed uploads */
+    vlkDevice_->uploader().collectCompleted();
+    /* Destroy the resources released by the completed frames */
+    vlkDevice_->deletionQueue().collect();
+
+    if (renderThread_)
+    {
+        renderFramePipelined();
+        return;
+    }
+
     const auto minimized = mainWindow_->isMinimized();
+    recordFrame(minimized, nullptr);
+
+    engineParams_.timings.presentWaitDuration
+        = minimized ? 0.0 : mainRenderingContext_->frameWaitDuration();
+    updateGpuTimings();
+    /* The swapchain may have been rebuilt by a surface change */
+    engineParams_.presentation = mainRenderingContext_->presentation();
+}
+
+void VulkanRenderer::setRenderThreadEnabled(bool enabled)
+{
+    if (enabled == (renderThread_ != nullptr))
+        return;
+
+    if (enabled)
+    {
+        for (auto& packet : framePackets_)
+        {
+            packet = std::make_unique<ImGuiFramePacket>();
+        }
+        framePacketIndex_ = 0;
+        renderThread_ = std::make_unique<RenderThread>(jobSystem_);
+    }
+    else
+    {
+        /* Waits for the frame in flight */
+        renderThread_.reset();
+    }
+}
+
+void VulkanRenderer::setFrameReadback(
+    const std::string& directory,
+    uint32_t frameInterval)
+{
+    if (!mainRenderingContext_->isHeadless())
+    {
+        SPDLOG_LOGGER_WARN(
+            logger_, "Frame readback is only available in headless mode, ignored");
+        return;
+    }
+    /* The frame in flight may use the previous settings */
+    if (renderThread_)
+        renderThread_->waitIdle();
+    mainRenderingContext_->setReadback(directory, frameInterval);
+}
+
+void VulkanRenderer::setFramesInFlight(uint32_t framesInFlight)
+{
+    /* The frame objects are rebuilt : no frame may be recording */
+    if (renderThread_)
+        renderThread_->waitIdle();
+    /* Platform windows created afterwards clone the main context, count included */
+    mainRenderingContext_->setFramesInFlight(framesInFlight);
+}
+
+void VulkanRenderer::setGraphicSettings(const GraphicSettings& graphicSettings)
+{
+    engineParams_.graphicSettings = graphicSettings;
+    /* The swapchain may be rebuilt : no frame may be recording */
+    if (renderThread_)
+        renderThread_->waitIdle();
+    /* Platform windows created afterwards clone the main context, settings
+     * included. The live ones are updated along with it. */
+    mainRenderingContext_->setGraphicSettings(graphicSettings);
+    imguiBackend_->forEachPlatformRenderingContext(
+        [&graphicSettings](RenderingContext& renderingContext) {
+            dynamic_cast<VulkanRenderingContext&>(renderingContext)
+                .setGraphicSettings(graphicSettings);
+        });
+    engineParams_.presentation = mainRenderingContext_->presentation();
+}
+
+void VulkanRenderer::renderFramePipelined()
+{
+    /* Copy the UI of this frame while the previous one is still being rendered */
+    ImGuiFramePacket& packet = *framePackets_[framePacketIndex_];
+    imguiBackend_->captureFrame(packet);
+
+    /* Platform windows and their rendering contexts can only be created, resized
+     * or destroyed while no frame is in flight. The render thread waits there for
+     * the GPU and the swapchain : the whole handoff counts as the present wait. */
+    Timer waitTimer;
+    renderThread_->waitIdle();
+    engineParams_.timings.presentWaitDuration
+        = waitTimer.getElapsedTime<Milliseconds>();
+    imguiBackend_->updatePlatformWindows(packet);
+    /* Written by the render thread, read while it is idle */
+    updateGpuTimings();
+    engineParams_.presentation = mainRenderingContext_->presentation();
+
+    const auto minimized = mainWindow_->isMinimized();
+    renderThread_->submit(
+        [this, &packet, minimized]() { recordFrame(minimized, &packet); });
+
+    framePacketIndex_
+        = (framePacketIndex_ + 1) % static_cast<uint32_t>(framePackets_.size());
+}
+
+void VulkanRenderer::recordFrame(bool minimized, ImGuiFramePacket* packet)
+{
     if (!minimized)
         mainRenderingContext_->beginFrame();
-    imguiBackend_->renderFrame();
+    if (packet)
+        imguiBackend_->renderFramePacket(*packet);
+    else
+        imguiBackend_->renderFrame();
     /* TODO Main RC rendering here */
     if (!minimized)
         mainRenderingContext_->submitFrame();
 }
 
+void VulkanRenderer::updateGpuTimings()
+{
+    engineParams_.timings.gpu = mainRenderingContext_->gpuTimings();
+
+    auto& windowsGpu = engineParams_.timings.windowsGpu;
+    windowsGpu.clear();
+    imguiBackend_->forEachPlatformRenderingContext(
+        [&windowsGpu](RenderingContext& renderingContext) {
+            auto& vlkRenderingContext
+                = dynamic_cast<VulkanRenderingContext&>(renderingContext);
+            windowsGpu.push_back(
+                {.windowId = vlkRenderingContext.window().getWindowId(),
+                 .timings = vlkRenderingContext.gpuTimings()});
+        });
+}
+
 bool VulkanRenderer::handleEvent(const SDL_Event& event)
 {
     bool handled = imguiBackend_->handleEvent(event);
@@ -82,11 +274,19 @@ bool VulkanRenderer::handleEvent(const SDL_Event& event)
     return handled;
 }
 
-void VulkanRenderer::waitIdle() { vlkDevice_->waitIdle(); }
+void VulkanRenderer::waitIdle()
+{
+    if (renderThread_)
+        renderThread_->waitIdle();
+    /* Also writes the pending headless readbacks */
+    mainRenderingContext_->waitIdle();
+    /* The other contexts */
+    vlkDevice_->waitIdle();
+}
 
 std::shared_ptr<Window> VulkanRenderer::getMainWindow() const
 {
-    return std::static_pointer_cast<Window>(mainWindow_);
+    return mainWindow_;
 }
 
 std::unique_ptr<Texture> VulkanRenderer::createTexture() { return nullptr; }
@@ -94,7 +294,7 @@ std::unique_ptr<Texture> VulkanRenderer::createTexture() { return nullptr; }
 vk::UniqueInstance VulkanRenderer::createVulkanInstance(
     const std::string& appName,
     const uint32_t appVersion,
-    const vlk::VulkanWindow& window) const
+    std::vector<const char*> extensions) const
 {
     /* Check layer support */
     EXPENGINE_ASSERT(
@@ -103,11 +303,16 @@ vk::UniqueInstance VulkanRenderer::createVulkanInstance(
         "Validation layer(s) requested, but not available.");
 
     /* Acquire all the required extensions */
-    std::vector<const char*> extensions = window.getRequiredVkExtensions();
     if (vlk::ENABLE_VALIDATION_LAYERS)
     {
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
     }
+    /* Optional : needed to query the descriptor indexing support */
+    if (vlk::isInstanceExtensionAvailable(
+            VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+    {
+        extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+    }
 
     /* Check extension support */
     EXPENGINE_ASSERT(
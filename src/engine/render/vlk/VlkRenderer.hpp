@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include <SDL2\SDL_events.h>
 
 #include <engine/render/Renderer.hpp>
@@ -8,6 +10,9 @@
 namespace experim {
 
 class ImguiBackend;
+class ImGuiFramePacket;
+class JobSystem;
+class RenderThread;
 class Texture;
 
 namespace vlk {
@@ -24,13 +29,20 @@ public:
         const uint32_t appVersion,
         int windowWidth,
         int windoHeight,
-        EngineParameters& engineParams);
+        EngineParameters& engineParams,
+        JobSystem& jobSystem,
+        bool headless = false);
 
     ~VulkanRenderer() override;
 
     bool handleEvent(const SDL_Event& event) override;
     void prepareFrame() override;
     void renderFrame() override;
+    void setRenderThreadEnabled(bool enabled) override;
+    void setFrameReadback(const std::string& directory, uint32_t frameInterval)
+        override;
+    void setFramesInFlight(uint32_t framesInFlight) override;
+    void setGraphicSettings(const GraphicSettings& graphicSettings) override;
 
     void waitIdle() override;
     std::shared_ptr<Window> getMainWindow() const override;
@@ -40,16 +52,29 @@ public:
     /* Implement IRendering */
     std::unique_ptr<Texture> createTexture() override;
 
+    /** Used by the UI backend to record its draw lists in parallel */
+    inline JobSystem& jobs() const { return jobSystem_; };
+
 private:
+    /* References */
+    JobSystem& jobSystem_;
+
     /* Vulkan objects */
     vk::UniqueInstance vkInstance_;
-    std::shared_ptr<VulkanWindow> mainWindow_;
+    /* A VulkanWindow, or a HeadlessWindow when rendering offscreen */
+    std::shared_ptr<Window> mainWindow_;
     std::unique_ptr<vlk::Device> vlkDevice_;
     std::shared_ptr<vlk::VulkanRenderingContext> mainRenderingContext_;
 
     /* UI */
     std::unique_ptr<ImguiBackend> imguiBackend_;
 
+    /* Pipelined rendering. Null when frames are rendered on the main thread. */
+    std::unique_ptr<RenderThread> renderThread_;
+    /* Double-buffered : one packet is built while the other one is rendered */
+    std::array<std::unique_ptr<ImGuiFramePacket>, 2> framePackets_;
+    uint32_t framePacketIndex_;
+
     /* TODO : vk::UniqueDebugUtilsMessengerEXT */
     /**  @brief Only used in debug mode. */
     vk::DebugUtilsMessengerEXT vkDebugMessenger_;
@@ -57,10 +82,19 @@ private:
     vk::UniqueInstance createVulkanInstance(
         const std::string& appName,
         const uint32_t appVersion,
-        const vlk::VulkanWindow& window) const;
+        std::vector<const char*> extensions) const;
     vk::DebugUtilsMessengerEXT setupDebugMessenger(
         vk::Instance instance,
         bool enableValidationLayers) const;
+
+    void renderFramePipelined();
+    /* Records and submits the frame of the main rendering context, UI included.
+     * packet is null when the frame is rendered on the main thread, else the
+     * captured UI to render on the render thread. */
+    void recordFrame(bool minimized, ImGuiFramePacket* packet);
+    /* Copies the GPU timings of every rendering context. No frame may be
+     * recording. */
+    void updateGpuTimings();
 };
 
 } // namespace vlk
@@ -1,15 +1,75 @@
 #include "VlkRenderingContext.hpp"
 
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+
+#include <engine/jobs/JobSystem.hpp>
 #include <engine/log/ExpengineLog.hpp>
+#include <engine/profiling/Profiler.hpp>
+#include <engine/render/HeadlessWindow.hpp>
+#include <engine/render/vlk/VlkCommandBuffer.hpp>
 #include <engine/render/vlk/VlkDebug.hpp>
+#include <engine/render/vlk/VlkDeletionQueue.hpp>
+#include <engine/render/vlk/VlkDescriptorAllocator.hpp>
 #include <engine/render/vlk/VlkDevice.hpp>
 #include <engine/render/vlk/VlkFrameCommandBuffer.hpp>
+#include <engine/render/vlk/VlkFrameCommandPool.hpp>
+#include <engine/render/vlk/VlkOffscreenTarget.hpp>
+#include <engine/render/vlk/VlkQueueTimeline.hpp>
+#include <engine/render/vlk/VlkSceneTarget.hpp>
 #include <engine/render/vlk/VlkSwapchain.hpp>
+#include <engine/render/vlk/VlkUploader.hpp>
 #include <engine/render/vlk/VlkWindow.hpp>
+#include <engine/utils/Timer.hpp>
 
 namespace {
-/* Timeout when waiting on a synchronization fence : 15 s*/
-const uint64_t FENCE_WAIT_TIMEOUT_NANOSEC = 15000000000;
+/* Timeout when waiting on a frame : 15 s*/
+const uint64_t FRAME_WAIT_TIMEOUT_NANOSEC = 15000000000;
+/* Per frame : 2 timestamps per render pass. Further passes are not timed. */
+const uint32_t MAX_FRAME_TIMESTAMPS = 32;
+const double NANOSEC_PER_MILLISEC = 1000000.0;
+/* Command pools per frame, one per JobSystem thread index */
+const uint32_t MAX_RECORDING_THREADS = 64;
+const uint32_t NO_SCENE_QUERY = UINT32_MAX;
+
+/* Signed difference a - b between two timestamps masked to their valid bits. The
+ * modulo arithmetic also handles a wrap of the counter. */
+int64_t timestampDelta(uint64_t a, uint64_t b, uint64_t mask)
+{
+    const uint64_t delta = (a - b) & mask;
+    /* Over half of the range : b is after a */
+    if (delta > mask / 2)
+        return -static_cast<int64_t>((b - a) & mask);
+    return static_cast<int64_t>(delta);
+}
+
+vk::PresentModeKHR toVkPresentMode(experim::PresentMode presentMode)
+{
+    switch (presentMode)
+    {
+    case experim::PresentMode::eMailbox:
+        return vk::PresentModeKHR::eMailbox;
+    case experim::PresentMode::eImmediate:
+        return vk::PresentModeKHR::eImmediate;
+    default:
+        return vk::PresentModeKHR::eFifo;
+    }
+}
+
+experim::PresentMode fromVkPresentMode(vk::PresentModeKHR presentMode)
+{
+    switch (presentMode)
+    {
+    case vk::PresentModeKHR::eMailbox:
+        return experim::PresentMode::eMailbox;
+    case vk::PresentModeKHR::eImmediate:
+        return experim::PresentMode::eImmediate;
+    default:
+        /* FIFO relaxed is never requested */
+        return experim::PresentMode::eFifo;
+    }
+}
 } // namespace
 
 namespace experim {
@@ -20,35 +80,77 @@ namespace vlk {
  * -> 1 Surface
  * -> 1 SwapChain
  * -> 1 Render pass shared by UI and application
+ * -> With dynamic resolution, 1 Scene image per frame in flight, upscaled into
+ * the image before the UI render pass
  * -> 2 Graphics pipeline : 1 owned by ImGui Viewport, 1 for the application
  * rendering (not yet implemented)
+ * -> Per Frame in flight (x framesInFlight, independent of image_count)
+ * --> 1 Command pool per recording thread
+ * --> n Command buffer (1 for the UI for now), primary or secondary
+ * --> 1 Graphics timeline value (no sync object)
+ * --> 1 Timestamp query pool (if supported)
+ * --> 1 Semaphore (imageAcquired)
  * -> Per Image (x image_count)
- * --> 1 Command pool
- * --> n Command buffer (1 for the UI for now)
- * --> 1 Fence
- * --> 2 Semaphores
  * --> 1 Image view  (BackbufferView)
- * --> 1 Framebuffer */
+ * --> 1 Framebuffer
+ * --> 1 Semaphore (renderComplete)
+ * A headless RenderingContext has no surface, and replaces the swapchain and the
+ * semaphores by offscreen images, one per frame in flight. */
 
 VulkanRenderingContext::VulkanRenderingContext(
     const Device& device,
     std::shared_ptr<VulkanWindow> window,
     AttachmentsFlags attachmentsFlags,
+    uint32_t framesInFlight,
+    const GraphicSettings& graphicSettings,
     std::function<void(void)> surfaceChangeCallback)
     : RenderingContext(surfaceChangeCallback)
     , window_(window)
     , device_(device)
     , attachmentsFlags_(attachmentsFlags)
+    , headless_(false)
+    , framesInFlight_(std::clamp(framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT))
+    , graphicSettings_(graphicSettings)
     , frameIndex_(0)
-    , semaphoreIndex_(0)
+    , imageIndex_(0)
+    , frameWaitDuration_(0.0)
+    , readbackInterval_(0)
+    , submittedFrames_(0)
+    , submittedValue_(0)
 {
     SPDLOG_LOGGER_DEBUG(logger_, "VulkanRenderingContext creation");
     /* Create surface */
     auto [surfaceCreated, surface]
-        = window_->createVkSurface(device.instanceHandle());
+        = window->createVkSurface(device.instanceHandle());
     EXPENGINE_ASSERT(surfaceCreated, "Failed to create a VkSurface");
     windowSurface_ = vk::UniqueSurfaceKHR(surface, device.instanceHandle());
 
+    configureRenderScale();
+    auto [w, h] = window_->getDrawableSizeInPixels();
+    buildSwapchainObjects({w, h});
+}
+
+VulkanRenderingContext::VulkanRenderingContext(
+    const Device& device,
+    std::shared_ptr<HeadlessWindow> window,
+    AttachmentsFlags attachmentsFlags,
+    uint32_t framesInFlight,
+    std::function<void(void)> surfaceChangeCallback)
+    : RenderingContext(surfaceChangeCallback)
+    , window_(window)
+    , device_(device)
+    , attachmentsFlags_(attachmentsFlags)
+    , headless_(true)
+    , framesInFlight_(std::clamp(framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT))
+    , frameIndex_(0)
+    , imageIndex_(0)
+    , frameWaitDuration_(0.0)
+    , readbackInterval_(0)
+    , submittedFrames_(0)
+    , submittedValue_(0)
+{
+    SPDLOG_LOGGER_DEBUG(logger_, "Headless VulkanRenderingContext creation");
+
     auto [w, h] = window_->getDrawableSizeInPixels();
     buildSwapchainObjects({w, h});
 }
@@ -56,6 +158,25 @@ VulkanRenderingContext::VulkanRenderingContext(
 VulkanRenderingContext::~VulkanRenderingContext()
 {
     SPDLOG_LOGGER_DEBUG(logger_, "VulkanRenderingContext destruction");
+    if (headless_)
+    {
+        /* Writes the pending readbacks */
+        waitIdle();
+        return;
+    }
+
+    /* No wait : the frame objects, retired or not, may still be in use. They are
+     * destroyed once the frames are complete. */
+    ReleasedContextObjects objects;
+    objects.window_ = std::move(window_);
+    objects.windowSurface_ = std::move(windowSurface_);
+    objects.vlkSwapchain_ = std::move(vlkSwapchain_);
+    objects.sceneTarget_ = std::move(sceneTarget_);
+    objects.renderPass_ = std::move(renderPass_);
+    objects.retiredObjects_ = std::move(retiredObjects_);
+    objects.images_ = std::move(images_);
+    objects.frames_ = std::move(frames_);
+    device_.deletionQueue().release(std::move(objects), submittedValue_);
 }
 
 inline const Window& VulkanRenderingContext::window() const { return *window_; }
@@ -64,8 +185,17 @@ std::shared_ptr<RenderingContext> VulkanRenderingContext::clone(
     std::shared_ptr<Window> window,
     AttachmentsFlags attachmentFlags)
 {
+    EXPENGINE_ASSERT(
+        !headless_, "A headless RenderingContext can't create window contexts");
+    /* Platform windows only render UI : always at their native resolution */
+    GraphicSettings graphicSettings = graphicSettings_;
+    graphicSettings.targetGpuFrameDuration = 0.0;
     auto renderingContext = std::make_shared<VulkanRenderingContext>(
-        device_, std::dynamic_pointer_cast<VulkanWindow>(window), attachmentFlags);
+        device_,
+        std::dynamic_pointer_cast<VulkanWindow>(window),
+        attachmentFlags,
+        framesInFlight_,
+        graphicSettings);
     return renderingContext;
 }
 
@@ -74,38 +204,101 @@ void VulkanRenderingContext::buildSwapchainObjects(
     vk::SwapchainKHR oldSwapchainHandle)
 {
     SPDLOG_LOGGER_DEBUG(logger_, "buildSwapchainObjects");
-    /* Create SwapChain with images */
-    auto newSwapchain = std::make_unique<vlk::Swapchain>(
-        device_, *windowSurface_, requestedExtent, oldSwapchainHandle);
-    vlkSwapchain_ = std::move(newSwapchain);
+    if (headless_)
+    {
+        /* Create the offscreen images, one per frame in flight */
+        offscreenTarget_ = std::make_unique<vlk::OffscreenTarget>(
+            device_, requestedExtent, framesInFlight_);
+    }
+    else
+    {
+        /* Create SwapChain with images */
+        auto newSwapchain = std::make_unique<vlk::Swapchain>(
+            device_,
+            *windowSurface_,
+            requestedExtent,
+            toVkPresentMode(graphicSettings_.presentMode),
+            graphicSettings_.minImageCount,
+            oldSwapchainHandle);
+        /* The previous frames may still be rendering or presenting */
+        if (vlkSwapchain_)
+            retireSwapchainObjects();
+        vlkSwapchain_ = std::move(newSwapchain);
+    }
+
+    /* Create the scene target when the resolution is dynamic. The previous one was
+     * retired with the swapchain, or is idle when headless. */
+    sceneTarget_.reset();
+    if (graphicSettings_.targetGpuFrameDuration > 0.0)
+    {
+        const bool canUpscale
+            = (headless_
+               || vlkSwapchain_->getImageUsage()
+                   & vk::ImageUsageFlagBits::eTransferDst)
+            && SceneTarget::isFormatSupported(device_, imageFormat());
+        if (canUpscale && device_.timestampPeriod() > 0.0f)
+        {
+            sceneTarget_ = std::make_unique<vlk::SceneTarget>(
+                device_, imageFormat(), imageExtent(), framesInFlight_);
+        }
+        else
+        {
+            SPDLOG_LOGGER_WARN(
+                logger_,
+                "Dynamic resolution requires GPU timestamps and blittable images, "
+                "ignored");
+        }
+    }
 
     /* Create Render pass */
-    renderPass_ = createRenderPass(device_, *vlkSwapchain_, attachmentsFlags_);
+    renderPass_ = createRenderPass(device_, imageFormat(), attachmentsFlags_);
 
-    /* Create frame objects : Image views, Framebuffers, Command pools,
-     * Command buffers and Sync objects */
-    createFrameObjects(frames_, *vlkSwapchain_, *renderPass_, attachmentsFlags_);
+    /* Create image objects : Image views, Framebuffers and renderComplete
+     * semaphores */
+    const auto& images
+        = headless_ ? offscreenTarget_->getImages() : vlkSwapchain_->getImages();
+    createImageObjects(images, *renderPass_, attachmentsFlags_);
+
+    /* Create frame objects : Command pools, Command buffers and Sync objects */
+    createFrameObjects();
 }
 
-void VulkanRenderingContext::createFrameObjects(
-    std::vector<FrameObjects>& frames,
-    const vlk::Swapchain& swapchain,
-    vk::RenderPass& renderPass,
+void VulkanRenderingContext::rebuildSwapchainObjects(vk::Extent2D requestedExtent)
+{
+    if (headless_)
+    {
+        /* No presentation : waiting on the frames of the context is enough, and
+         * writes their pending readbacks */
+        waitIdle();
+        buildSwapchainObjects(requestedExtent);
+    }
+    else
+    {
+        /* No wait : the previous objects are retired, and destroyed once their
+         * frames are complete. Other contexts keep rendering. */
+        buildSwapchainObjects(requestedExtent, vlkSwapchain_->getHandle());
+    }
+
+    /* Signal that objects were rebuilt */
+    if (surfaceChangeCallback_)
+        surfaceChangeCallback_();
+}
+
+void VulkanRenderingContext::createImageObjects(
+    const std::vector<vk::Image>& images,
+    vk::RenderPass renderPass,
     AttachmentsFlags attachmentsFlags)
 {
-    /* Destroy the previous frame objects */
-    frames.clear();
-    semaphores_.clear();
-    semaphoreToFrameFence_.clear();
-    frameIndex_ = 0;
-    semaphoreIndex_ = 0;
+    /* Destroy the previous image objects */
+    images_.clear();
+    imageIndex_ = 0;
 
-    /* Configuration shared by all the frames */
+    /* Configuration shared by all the images */
 
     /* Image view */
     vk::ImageViewCreateInfo imageViewInfo
         = {.viewType = vk::ImageViewType::e2D,
-           .format = swapchain.getSurfaceFormat().format,
+           .format = imageFormat(),
            .components
            = {.r = vk::ComponentSwizzle::eR,
               .g = vk::ComponentSwizzle::eG,
@@ -114,13 +307,13 @@ void VulkanRenderingContext::createFrameObjects(
            .subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1}};
 
     /* Framebuffer */
-    auto imageExtent = swapchain.getImageExtent();
+    auto extent = imageExtent();
     std::array<vk::ImageView, 2> attachments;
     vk::FramebufferCreateInfo framebufferInfo
         = {.renderPass = renderPass,
            .pAttachments = attachments.data(),
-           .width = imageExtent.width,
-           .height = imageExtent.height,
+           .width = extent.width,
+           .height = extent.height,
            .layers = 1};
 
     if (attachmentsFlags & AttachmentsFlagBits::eColorAttachment)
@@ -132,8 +325,8 @@ void VulkanRenderingContext::createFrameObjects(
         framebufferInfo.attachmentCount++;
     }
 
-    /* Create 1 frame object for each swapchain image */
-    for (const auto& image : swapchain.getImages())
+    /* Create 1 image object for each swapchain image */
+    for (const auto& image : images)
     {
         /* Create the image view */
         imageViewInfo.image = image;
@@ -150,48 +343,87 @@ void VulkanRenderingContext::createFrameObjects(
             = device_.deviceHandle().createFramebufferUnique(framebufferInfo);
         EXPENGINE_VK_ASSERT(framebufferResult, "Failed to create a framebuffer");
 
-        /* Create the command pool */
-        auto [cmdPoolResult, commandPool]
-            = device_.deviceHandle().createCommandPoolUnique(
-                {.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-                 .queueFamilyIndex = device_.queueIndices().graphicsFamily.value()});
-        EXPENGINE_VK_ASSERT(framebufferResult, "Failed to create a command pool");
+        ImageObjects imageObjects;
+        imageObjects.imageView_ = std::move(imageView);
+        imageObjects.framebuffer_ = std::move(framebuffer);
+
+        /* No presentation engine to synchronize with */
+        if (!headless_)
+        {
+            auto renderCompleteSemaphore
+                = device_.deviceHandle().createSemaphoreUnique({});
+            EXPENGINE_VK_ASSERT(
+                renderCompleteSemaphore.result,
+                "Failed to create the renderComplete Semaphore");
+            imageObjects.renderComplete_
+                = std::move(renderCompleteSemaphore.value);
+        }
+        images_.push_back(std::move(imageObjects));
+    }
+}
 
-        /* Create the fence */
-        auto [fenceResult, fence] = device_.deviceHandle().createFenceUnique(
-            {.flags = vk::FenceCreateFlagBits::eSignaled});
-        EXPENGINE_VK_ASSERT(fenceResult, "Failed to create a fence");
+void VulkanRenderingContext::createFrameObjects()
+{
+    /* Destroy the previous frame objects */
+    frames_.clear();
+    frameIndex_ = 0;
+
+    for (uint32_t i = 0; i < framesInFlight_; i++)
+    {
+        /* Create the command pool of the main thread, slot 0. The pools of the
+         * other threads are created on their first request. The framebuffer is
+         * only known once the image is acquired : it is set on reset. */
+        std::vector<std::unique_ptr<FrameCommandPool>> commandPools(
+            MAX_RECORDING_THREADS);
+        commandPools[0] = std::make_unique<FrameCommandPool>(
+            device_, *renderPass_, nullptr, imageExtent());
+
+        /* Create the transient descriptor allocator. Its pools are only created
+         * on the first allocation. */
+        auto transientDescriptors = std::make_unique<DescriptorAllocator>(
+            device_,
+            std::vector<vk::DescriptorPoolSize> {
+                {.type = vk::DescriptorType::eCombinedImageSampler,
+                 .descriptorCount = 1}});
+
+        /* Create the timestamp query pool */
+        vk::UniqueQueryPool timestampPool;
+        if (device_.timestampPeriod() > 0.0f)
+        {
+            auto [queryPoolResult, queryPool]
+                = device_.deviceHandle().createQueryPoolUnique(
+                    {.queryType = vk::QueryType::eTimestamp,
+                     .queryCount = MAX_FRAME_TIMESTAMPS});
+            EXPENGINE_VK_ASSERT(queryPoolResult, "Failed to create a query pool");
+            timestampPool = std::move(queryPool);
+        }
 
         /* Create the Frame object */
         FrameObjects frame;
-        frame.imageView_ = std::move(imageView);
-        frame.framebuffer_ = std::move(framebuffer);
-        frame.commandPool_ = std::move(commandPool);
-        frame.fence_ = std::move(fence);
-        frames_.push_back(std::move(frame));
-
-        /* Create the semaphores */
-        auto imageAcqSemaphore = device_.deviceHandle().createSemaphoreUnique({});
-        EXPENGINE_VK_ASSERT(
-            imageAcqSemaphore.result,
-            "Failed to create the imageAcquired Semaphore");
-        auto renderCompleteSemaphore
-            = device_.deviceHandle().createSemaphoreUnique({});
-        EXPENGINE_VK_ASSERT(
-            renderCompleteSemaphore.result,
-            "Failed to create the renderComplete Semaphore");
+        frame.commandPools_ = std::move(commandPools);
+        frame.transientDescriptors_ = std::move(transientDescriptors);
+        frame.submittedValue_ = 0;
+        frame.timestampPool_ = std::move(timestampPool);
+        frame.timestampQueryCount_ = 0;
+        frame.sceneTimestampQuery_ = NO_SCENE_QUERY;
 
-        /* Create a Frame Semaphore object */
-        FrameSemaphores semaphoreObject;
-        semaphoreObject.imageAcquired_ = std::move(imageAcqSemaphore.value);
-        semaphoreObject.renderComplete_ = std::move(renderCompleteSemaphore.value);
-        semaphores_.push_back(std::move(semaphoreObject));
+        /* No presentation engine to synchronize with */
+        if (!headless_)
+        {
+            auto imageAcqSemaphore
+                = device_.deviceHandle().createSemaphoreUnique({});
+            EXPENGINE_VK_ASSERT(
+                imageAcqSemaphore.result,
+                "Failed to create the imageAcquired Semaphore");
+            frame.imageAcquired_ = std::move(imageAcqSemaphore.value);
+        }
+        frames_.push_back(std::move(frame));
     }
 }
 
 vk::UniqueRenderPass VulkanRenderingContext::createRenderPass(
     const vlk::Device& device,
-    const vlk::Swapchain& swapchain,
+    vk::Format imageFormat,
     AttachmentsFlags attachmentsFlags)
 {
     /* Init subpass */
@@ -209,15 +441,21 @@ vk::UniqueRenderPass VulkanRenderingContext::createRenderPass(
     vk::AttachmentReference colorAttachmentRef;
     if (attachmentsFlags & AttachmentsFlagBits::eColorAttachment)
     {
+        /* With dynamic resolution, the upscaled scene is drawn over */
         vk::AttachmentDescription colorAttachment {
-            .format = swapchain.getSurfaceFormat().format,
+            .format = imageFormat,
             .samples = vk::SampleCountFlagBits::e1,
-            .loadOp = vk::AttachmentLoadOp::eClear,
+            .loadOp = sceneTarget_ ? vk::AttachmentLoadOp::eLoad
+                                   : vk::AttachmentLoadOp::eClear,
             .storeOp = vk::AttachmentStoreOp::eStore,
             .stencilLoadOp = vk::AttachmentLoadOp::eDontCare,
             .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
-            .initialLayout = vk::ImageLayout::eUndefined,
-            .finalLayout = vk::ImageLayout::ePresentSrcKHR};
+            .initialLayout = sceneTarget_ ? vk::ImageLayout::eColorAttachmentOptimal
+                                          : vk::ImageLayout::eUndefined,
+            /* Offscreen images are only read back, no present layout without
+             * the swapchain extension */
+            .finalLayout = headless_ ? vk::ImageLayout::eTransferSrcOptimal
+                                     : vk::ImageLayout::ePresentSrcKHR};
         colorAttachmentRef
             = {.attachment = static_cast<uint32_t>(attachments.size()),
                .layout = vk::ImageLayout::eColorAttachmentOptimal};
@@ -270,140 +508,241 @@ vk::UniqueRenderPass VulkanRenderingContext::createRenderPass(
     return std::move(renderPass);
 }
 
-vk::UniquePipeline VulkanRenderingContext::createGraphicsPipeline(
-    vk::GraphicsPipelineCreateInfo& pipelineInfos)
+RenderPassCompatibility VulkanRenderingContext::renderPassCompatibility() const
 {
-    pipelineInfos.renderPass = *renderPass_;
-
-    auto [result, graphicsPipeline]
-        = device_.deviceHandle().createGraphicsPipelineUnique(
-            nullptr, pipelineInfos);
-    EXPENGINE_VK_ASSERT(result, "Failed to create a graphics pipeline");
-
-    return std::move(graphicsPipeline);
+    /* Matches the attachments of createRenderPass */
+    RenderPassCompatibility compatibility;
+    if (attachmentsFlags_ & AttachmentsFlagBits::eColorAttachment)
+        compatibility.colorFormat = imageFormat();
+    if (attachmentsFlags_ & AttachmentsFlagBits::eDepthAttachments)
+        compatibility.depthFormat = device_.getDepthFormat();
+    return compatibility;
 }
 
 void VulkanRenderingContext::handleSurfaceChanges()
 {
     SPDLOG_LOGGER_DEBUG(logger_, "handleSurfaceChanges");
 
+    if (headless_)
+    {
+        auto [w, h] = window_->getDrawableSizeInPixels();
+        if (vk::Extent2D {w, h} != offscreenTarget_->getRequestedExtent())
+            rebuildSwapchainObjects({w, h});
+        return;
+    }
+
     auto [result, surfaceProperties]
         = device_.getSurfaceCapabilities(windowSurface_.get());
     EXPENGINE_VK_ASSERT(result, "Failed to get surface capabilities");
 
     if (surfaceProperties.currentExtent != vlkSwapchain_->getRequestedExtent())
+        rebuildSwapchainObjects(surfaceProperties.currentExtent);
+}
+
+void VulkanRenderingContext::setFramesInFlight(uint32_t framesInFlight)
+{
+    EXPENGINE_ASSERT(
+        !frameToSubmit_, "Error, setFramesInFlight() called during a frame");
+    framesInFlight = std::clamp(framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+    if (framesInFlight == framesInFlight_)
+        return;
+
+    SPDLOG_LOGGER_DEBUG(logger_, "{} frames in flight", framesInFlight);
+    framesInFlight_ = framesInFlight;
+    rebuildSwapchainObjects(
+        headless_ ? offscreenTarget_->getRequestedExtent()
+                  : vlkSwapchain_->getRequestedExtent());
+}
+
+void VulkanRenderingContext::setGraphicSettings(
+    const GraphicSettings& graphicSettings)
+{
+    EXPENGINE_ASSERT(
+        !frameToSubmit_, "Error, setGraphicSettings() called during a frame");
+    /* No presentation when headless */
+    const bool presentChanged = !headless_
+        && (graphicSettings.presentMode != graphicSettings_.presentMode
+            || graphicSettings.minImageCount != graphicSettings_.minImageCount);
+    /* The render pass loads the upscaled scene instead of clearing the image */
+    const bool scalingToggled = (graphicSettings.targetGpuFrameDuration > 0.0)
+        != (graphicSettings_.targetGpuFrameDuration > 0.0);
+    graphicSettings_ = graphicSettings;
+    configureRenderScale();
+    if (!presentChanged && !scalingToggled)
+        return;
+
+    rebuildSwapchainObjects(
+        headless_ ? offscreenTarget_->getRequestedExtent()
+                  : vlkSwapchain_->getRequestedExtent());
+    if (headless_)
+        return;
+    SPDLOG_LOGGER_INFO(
+        logger_,
+        "Swapchain rebuilt : present mode '{}', min image count {}, {} images",
+        vlkSwapchain_->getPresentMode(),
+        vlkSwapchain_->getMinImageCount(),
+        vlkSwapchain_->getImageCount());
+}
+
+PresentationInfo VulkanRenderingContext::presentation() const
+{
+    PresentationInfo presentation;
+    presentation.renderScale = sceneTarget_ ? renderScale_.scale() : 1.0f;
+    if (headless_)
     {
-        /* TODO Can I do better than a device wait ? Queue / Last used fence ? */
-        device_.waitIdle();
-        buildSwapchainObjects(
-            surfaceProperties.currentExtent, vlkSwapchain_->getHandle());
-        /* Signal that objects were rebuilt */
-        if (surfaceChangeCallback_)
-            surfaceChangeCallback_();
+        presentation.presentMode = graphicSettings_.presentMode;
+        return presentation;
     }
+    presentation.presentMode = fromVkPresentMode(vlkSwapchain_->getPresentMode());
+    presentation.minImageCount = vlkSwapchain_->getMinImageCount();
+    presentation.imageCount = vlkSwapchain_->getImageCount();
+    return presentation;
 }
 
 void VulkanRenderingContext::beginFrame()
 {
+    EXPENGINE_PROFILE_ZONE("VulkanRenderingContext::beginFrame");
     EXPENGINE_ASSERT(
         !frameToSubmit_, "Error, beginFrame() was called instead of submitFrame()");
 
-    /* Here we check for the semaphore availability. If semaphoreIndex_ is
-     * still used by a frame not yet submitted, we wait for its frame to be
-     * fully submitted. */
-    auto fenceIt = semaphoreToFrameFence_.find(semaphoreIndex_);
-    if (fenceIt != semaphoreToFrameFence_.end())
+    if (headless_)
     {
-        auto res = device_.deviceHandle().waitForFences(
-            fenceIt->second, VK_TRUE, FENCE_WAIT_TIMEOUT_NANOSEC);
-        EXPENGINE_VK_ASSERT(res, "Error while waiting on fence");
+        /* Offscreen image i belongs to frame i */
+        imageIndex_ = offscreenTarget_->acquireNextImage();
+        frameIndex_ = imageIndex_;
+        auto& frame = frames_.at(frameIndex_);
+
+        /* Wait for the previous use of this image, and write its readback */
+        Timer waitTimer;
+        waitForFrame(frame);
+        frameWaitDuration_ = waitTimer.getElapsedTime<Milliseconds>();
+        writePendingReadback(frameIndex_);
+        if (readTimestamps(frame) && sceneTarget_)
+            updateRenderScale();
+
+        resetCommandPools(frame);
+        frame.transientDescriptors_->reset();
+        frameToSubmit_ = true;
+        return;
     }
 
+    releaseRetiredObjects();
+
+    /* Wait for the previous submission of this frame : its command buffers,
+     * descriptors and imageAcquired semaphore are then free. */
+    auto* frame = &frames_.at(frameIndex_);
+    Timer waitTimer;
+    waitForFrame(*frame);
+
     /* Acquire an image from the swapchain */
-    vk::Semaphore& imgAcqSemaphore
-        = semaphores_[semaphoreIndex_].imageAcquired_.get();
-    auto acquiredImage = vlkSwapchain_->acquireNextImage(imgAcqSemaphore);
+    auto acquiredImage
+        = vlkSwapchain_->acquireNextImage(frame->imageAcquired_.get());
 
     /* Handle swapchain result : may recreate Context Objects */
     if (acquiredImage.result == vk::Result::eSuboptimalKHR
         || acquiredImage.result == vk::Result::eErrorOutOfDateKHR)
     {
         handleSurfaceChanges();
-        /* Refresh the semaphore, the index may have been reset by a surface
+        /* Refresh the frame, the frame objects may have been rebuilt by a surface
          * change */
-        imgAcqSemaphore = semaphores_[semaphoreIndex_].imageAcquired_.get();
-        acquiredImage = vlkSwapchain_->acquireNextImage(imgAcqSemaphore);
+        frame = &frames_.at(frameIndex_);
+        acquiredImage
+            = vlkSwapchain_->acquireNextImage(frame->imageAcquired_.get());
     }
     EXPENGINE_VK_ASSERT(acquiredImage.result, "Failed to acquire Swapchain image");
-    frameIndex_ = acquiredImage.value;
-    auto& frame = frames_.at(frameIndex_);
+    imageIndex_ = acquiredImage.value;
+    /* A surface change rebuild is counted in, it is rare enough */
+    frameWaitDuration_ = waitTimer.getElapsedTime<Milliseconds>();
 
-    /* If this frame is already in use, we wait on its fence for the frame to be
-     * fully submitted, before reusing it.
-     * "vk:queueSubmit" will signal the fence when the frame can be reused. */
-    /* We could check if the fence for this frame is the same as the frame
-     * we waited on for the semaphore above. But waitForFences should
-     * return immediately anyway if the fence is in the signaled state. */
-    auto res = device_.deviceHandle().waitForFences(
-        frame.fence_.get(), VK_TRUE, FENCE_WAIT_TIMEOUT_NANOSEC);
-    EXPENGINE_VK_ASSERT(res, "Error while waiting on fence");
-
-    /* Link (through its fence) the used semaphore ID to the Frame Object
-     * given by the SwapChain . */
-    semaphoreToFrameFence_.insert_or_assign(semaphoreIndex_, frame.fence_.get());
-
-    /* Reset command pool/buffers */
-    device_.deviceHandle().resetCommandPool(frame.commandPool_.get(), {});
-    /* TODO Rework command pool : we could/should keep some buffers to reuse since we
-     * did reset the command pool */
-    frame.commandBuffers_.clear();
-    frame.commandBufferHandles_.clear();
+    /* The frame is done : its results are available without waiting */
+    if (readTimestamps(*frame) && sceneTarget_)
+        updateRenderScale();
+
+    /* Reset command pool/buffers. The buffers are kept for reuse. */
+    resetCommandPools(*frame);
+    /* Same for the descriptor pools of the frame */
+    frame->transientDescriptors_->reset();
     frameToSubmit_ = true;
 }
 
 void VulkanRenderingContext::submitFrame()
 {
+    EXPENGINE_PROFILE_ZONE("VulkanRenderingContext::submitFrame");
     EXPENGINE_ASSERT(
         frameToSubmit_, "Error, submitFrame() was called instead of beginFrame()");
 
     auto& frame = frames_.at(frameIndex_);
 
-    /* Reset the fence before submitting the frame */
-    device_.deviceHandle().resetFences(frame.fence_.get());
+    /* The frame may use resources uploaded since the last one */
+    device_.uploader().flush();
+
+    if (sceneTarget_)
+        recordScene(frame);
+
+    if (headless_ && readbackInterval_ > 0
+        && submittedFrames_ % readbackInterval_ == 0
+        && !frame.commandBufferHandles_.empty())
+    {
+        /* Only if the image was rendered to, it is in an undefined layout
+         * otherwise */
+        recordReadback(frame);
+    }
+
+    submittedFrames_++;
 
-    /* Submit buffer(s) to queue. Will signal the fence and
-     * renderCompleteSem */
-    auto& imgAcqSem = semaphores_[semaphoreIndex_].imageAcquired_.get();
-    auto& renderCompleteSem = semaphores_[semaphoreIndex_].renderComplete_.get();
+    if (headless_)
+    {
+        vk::SubmitInfo submitInfo {
+            .commandBufferCount
+            = static_cast<uint32_t>(frame.commandBufferHandles_.size()),
+            .pCommandBuffers = frame.commandBufferHandles_.data()};
+        {
+            std::lock_guard<std::mutex> queueLock(device_.queueMutex());
+            frame.submittedValue_ = device_.graphicsTimeline().submit(submitInfo);
+            submittedValue_ = frame.submittedValue_;
+        }
+        frameToSubmit_ = false;
+        return;
+    }
+
+    /* Submit buffer(s) to queue. Will signal renderCompleteSem, then reach the
+     * submitted value */
+    auto& imgAcqSem = frame.imageAcquired_.get();
+    auto& renderCompleteSem = images_.at(imageIndex_).renderComplete_.get();
     vk::PipelineStageFlags waitStage
         = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+    /* The scene upscale writes the image first */
+    if (sceneTarget_)
+        waitStage |= vk::PipelineStageFlagBits::eTransfer;
     vk::SubmitInfo submitInfo {
         .waitSemaphoreCount = 1,
         .pWaitSemaphores = &imgAcqSem,
         .pWaitDstStageMask = &waitStage,
-        .commandBufferCount = static_cast<uint32_t>(frame.commandBuffers_.size()),
+        .commandBufferCount
+        = static_cast<uint32_t>(frame.commandBufferHandles_.size()),
         .pCommandBuffers = frame.commandBufferHandles_.data(),
         .signalSemaphoreCount = 1,
         .pSignalSemaphores = &renderCompleteSem};
-    auto res = device_.graphicsQueue().submit(submitInfo, frame.fence_.get());
-    EXPENGINE_VK_ASSERT(res, "Failed to submit frame to graphics queue");
+    vk::Result presentResult;
+    {
+        /* Uploads may be submitted from other threads */
+        std::lock_guard<std::mutex> queueLock(device_.queueMutex());
+        frame.submittedValue_ = device_.graphicsTimeline().submit(submitInfo);
+        submittedValue_ = frame.submittedValue_;
+
+        /* Present frame : will wait for renderCompleteSem */
+        presentResult = vlkSwapchain_->presentImage(
+            device_.presentQueue(), imageIndex_, renderCompleteSem);
+    }
+    /* The next frame. Independent from the order of the acquired images. */
+    frameIndex_ = (frameIndex_ + 1) % static_cast<uint32_t>(frames_.size());
 
-    /* Present frame : will wait for renderCompleteSem */
-    auto presentResult = vlkSwapchain_->presentImage(
-        device_.presentQueue(), frameIndex_, renderCompleteSem);
     /* Handle present result : may recreate swapchain */
     if (presentResult == vk::Result::eSuboptimalKHR
         || presentResult == vk::Result::eErrorOutOfDateKHR)
     {
         handleSurfaceChanges();
     }
-    else
-    {
-        /* Update sync resource index. The semaphore index itself is not tied to the
-         * frame index */
-        semaphoreIndex_
-            = (semaphoreIndex_ + 1) % static_cast<uint32_t>(semaphores_.size());
-    }
     frameToSubmit_ = false;
 }
 
@@ -414,28 +753,341 @@ vlk::FrameCommandBuffer& VulkanRenderingContext::requestCommandBuffer()
 
     auto& frame = frames_.at(frameIndex_);
 
-    frame.commandBuffers_.push_back(vlk::FrameCommandBuffer(
-        device_,
-        frame.commandPool_.get(),
-        *renderPass_,
-        frame.framebuffer_.get(),
-        vlkSwapchain_->getImageExtent()));
-    auto& commandBuffer = frame.commandBuffers_.back();
+    auto& commandBuffer = threadCommandPool(frame).request();
     frame.commandBufferHandles_.push_back(commandBuffer.getHandle());
 
     /* Start and return a command buffer for this frame */
     commandBuffer.begin(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
 
+    /* Reset here, so that queries left unwritten without a render pass are
+     * unavailable instead of holding the values of a previous frame */
+    if (frame.timestampPool_
+        && frame.timestampQueryCount_ + 2 <= MAX_FRAME_TIMESTAMPS)
+    {
+        commandBuffer.getHandle().resetQueryPool(
+            frame.timestampPool_.get(), frame.timestampQueryCount_, 2);
+        commandBuffer.setTimestampQueries(
+            frame.timestampPool_.get(), frame.timestampQueryCount_);
+        frame.timestampQueryCount_ += 2;
+    }
+
+    return commandBuffer;
+}
+
+vlk::FrameCommandBuffer& VulkanRenderingContext::requestSecondaryCommandBuffer()
+{
+    EXPENGINE_ASSERT(
+        frameToSubmit_, "Error, requestSecondaryCommandBuffer() outside of a frame");
+
+    auto& frame = frames_.at(frameIndex_);
+    auto& commandBuffer
+        = threadCommandPool(frame).request(vk::CommandBufferLevel::eSecondary);
+
+    /* Recorded inside the render pass of the frame */
+    vk::CommandBufferInheritanceInfo inheritanceInfo {
+        .renderPass = *renderPass_,
+        .subpass = 0,
+        .framebuffer = images_.at(imageIndex_).framebuffer_.get()};
+    commandBuffer.begin(
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit
+            | vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+        inheritanceInfo);
+
     return commandBuffer;
 }
 
+DescriptorAllocator& VulkanRenderingContext::transientDescriptorAllocator()
+{
+    EXPENGINE_ASSERT(
+        frameToSubmit_, "Error, transientDescriptorAllocator() outside of a frame");
+    return *frames_.at(frameIndex_).transientDescriptors_;
+}
+
+void VulkanRenderingContext::setReadback(
+    const std::string& directory,
+    uint32_t frameInterval)
+{
+    EXPENGINE_ASSERT(headless_, "Readback is only available in headless mode");
+    readbackDirectory_ = directory;
+    readbackInterval_ = frameInterval;
+    if (readbackInterval_ > 0)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(readbackDirectory_, error);
+        EXPENGINE_ASSERT(
+            !error, "Failed to create the readback directory {}", directory);
+    }
+}
+
 void VulkanRenderingContext::waitIdle()
 {
-    /* TODO Could do better
-     * 2 cases : frame prepared but not submitted, frame not prepared (similar to
-     * prepared and submitted). Wait on appropriate fence.
-     */
-    device_.waitIdle();
+    /* Submission order : the latest value is reached after all the frames,
+     * retired ones included */
+    bool completed = device_.graphicsTimeline().wait(
+        submittedValue_, FRAME_WAIT_TIMEOUT_NANOSEC);
+    EXPENGINE_ASSERT(completed, "Timeout while waiting on the frames");
+
+    /* All the frames are done */
+    for (uint32_t i = 0; i < frames_.size(); i++)
+    {
+        writePendingReadback(i);
+    }
+}
+
+void VulkanRenderingContext::retireSwapchainObjects()
+{
+    RetiredSwapchainObjects retired;
+    retired.frames_ = std::move(frames_);
+    retired.images_ = std::move(images_);
+    retired.swapchain_ = std::move(vlkSwapchain_);
+    retired.sceneTarget_ = std::move(sceneTarget_);
+    retired.renderPass_ = std::move(renderPass_);
+    retired.retiredFrame_ = submittedFrames_;
+    retired.submittedValue_ = 0;
+    for (const auto& frame : retired.frames_)
+    {
+        retired.submittedValue_
+            = std::max(retired.submittedValue_, frame.submittedValue_);
+    }
+    retiredObjects_.push_back(std::move(retired));
+
+    frames_.clear();
+    images_.clear();
+    SPDLOG_LOGGER_DEBUG(
+        logger_, "{} retired swapchain(s) pending", retiredObjects_.size());
+}
+
+void VulkanRenderingContext::releaseRetiredObjects()
+{
+    while (!retiredObjects_.empty())
+    {
+        auto& retired = retiredObjects_.front();
+
+        /* Presentation is not tracked by the timeline : the old images are only
+         * known to be released once the new swapchain went through all its
+         * images */
+        if (submittedFrames_ < retired.retiredFrame_ + images_.size()
+            || !device_.graphicsTimeline().isReached(retired.submittedValue_))
+            return;
+        retiredObjects_.pop_front();
+    }
+}
+
+void VulkanRenderingContext::waitForFrame(const FrameObjects& frame)
+{
+    bool completed = device_.graphicsTimeline().wait(
+        frame.submittedValue_, FRAME_WAIT_TIMEOUT_NANOSEC);
+    EXPENGINE_ASSERT(completed, "Timeout while waiting on a frame");
+}
+
+bool VulkanRenderingContext::readTimestamps(FrameObjects& frame)
+{
+    if (frame.timestampQueryCount_ == 0)
+        return false;
+
+    /* Each value is followed by its availability. The frame is complete : an
+     * unavailable query was not written, by a command buffer without render pass.
+     * eNotReady is then returned, but the available values are still written. */
+    std::array<uint64_t, MAX_FRAME_TIMESTAMPS * 2> results;
+    auto res = device_.deviceHandle().getQueryPoolResults(
+        frame.timestampPool_.get(),
+        0,
+        frame.timestampQueryCount_,
+        frame.timestampQueryCount_ * 2 * sizeof(uint64_t),
+        results.data(),
+        2 * sizeof(uint64_t),
+        vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability);
+    const uint32_t queryCount = frame.timestampQueryCount_;
+    const uint32_t sceneQuery = frame.sceneTimestampQuery_;
+    frame.timestampQueryCount_ = 0;
+    frame.sceneTimestampQuery_ = NO_SCENE_QUERY;
+    if (res != vk::Result::eSuccess && res != vk::Result::eNotReady)
+    {
+        EXPENGINE_VK_ASSERT(res, "Failed to read the timestamp queries");
+        return false;
+    }
+
+    /* The bits above timestampValidBits are undefined */
+    const uint32_t validBits = device_.timestampValidBits();
+    const uint64_t mask
+        = validBits >= 64 ? UINT64_MAX : (uint64_t(1) << validBits) - 1;
+    const double msPerTick = device_.timestampPeriod() / NANOSEC_PER_MILLISEC;
+
+    bool timed = false;
+    uint64_t frameOrigin = 0;
+    int64_t frameStart = 0;
+    int64_t frameEnd = 0;
+    double sceneDuration = 0.0;
+    gpuTimings_.passDurations.clear();
+    for (uint32_t query = 0; query < queryCount; query += 2)
+    {
+        if (results[query * 2 + 1] == 0 || results[query * 2 + 3] == 0)
+            continue;
+        const uint64_t start = results[query * 2] & mask;
+        const uint64_t end = results[query * 2 + 2] & mask;
+        const double duration = timestampDelta(end, start, mask) * msPerTick;
+        gpuTimings_.passDurations.push_back(duration);
+        if (query == sceneQuery)
+            sceneDuration = duration;
+
+        /* Relative to the first timed pass, which may not be the first executed */
+        if (!timed)
+            frameOrigin = start;
+        const int64_t relativeStart = timestampDelta(start, frameOrigin, mask);
+        const int64_t relativeEnd = timestampDelta(end, frameOrigin, mask);
+        frameStart = timed ? std::min(frameStart, relativeStart) : relativeStart;
+        frameEnd = timed ? std::max(frameEnd, relativeEnd) : relativeEnd;
+        timed = true;
+    }
+    /* Nothing was timed : keep the previous timings */
+    if (!timed)
+        return false;
+
+    gpuTimings_.frameDuration = (frameEnd - frameStart) * msPerTick;
+    gpuTimings_.sceneDuration = sceneDuration;
+    return true;
+}
+
+void VulkanRenderingContext::configureRenderScale()
+{
+    renderScale_.setScaleRange(graphicSettings_.minRenderScale, 1.0f);
+    renderScale_.setTargetFrameDuration(graphicSettings_.targetGpuFrameDuration);
+}
+
+void VulkanRenderingContext::updateRenderScale()
+{
+    /* Only the scene pass scales : the native resolution passes and the upscale
+     * take a fixed part of the budget */
+    renderScale_.update(
+        gpuTimings_.sceneDuration,
+        gpuTimings_.frameDuration - gpuTimings_.sceneDuration);
+}
+
+void VulkanRenderingContext::recordScene(FrameObjects& frame)
+{
+    /* From the pool of the recording thread, recycled in beginFrame */
+    auto& commandBuffer = threadCommandPool(frame).request();
+    commandBuffer.begin(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+
+    /* Only the scene pass is timed : its duration is the part of the frame that
+     * follows the scale */
+    const uint32_t firstQuery = frame.timestampQueryCount_;
+    const bool timed
+        = frame.timestampPool_ && firstQuery + 2 <= MAX_FRAME_TIMESTAMPS;
+    if (timed)
+    {
+        commandBuffer.getHandle().resetQueryPool(
+            frame.timestampPool_.get(), firstQuery, 2);
+        commandBuffer.getHandle().writeTimestamp(
+            vk::PipelineStageFlagBits::eTopOfPipe,
+            frame.timestampPool_.get(),
+            firstQuery);
+        frame.timestampQueryCount_ += 2;
+        frame.sceneTimestampQuery_ = firstQuery;
+    }
+
+    const auto renderExtent = sceneTarget_->getScaledExtent(renderScale_.scale());
+    sceneTarget_->recordScenePass(commandBuffer, frameIndex_, renderExtent);
+    if (timed)
+    {
+        commandBuffer.getHandle().writeTimestamp(
+            vk::PipelineStageFlagBits::eBottomOfPipe,
+            frame.timestampPool_.get(),
+            firstQuery + 1);
+    }
+
+    /* Loaded by the render pass of the other command buffers. Without them, the
+     * image goes straight to the final layout of the render pass. */
+    vk::ImageLayout dstLayout = vk::ImageLayout::eColorAttachmentOptimal;
+    if (frame.commandBufferHandles_.empty())
+    {
+        dstLayout = headless_ ? vk::ImageLayout::eTransferSrcOptimal
+                              : vk::ImageLayout::ePresentSrcKHR;
+    }
+    const auto& images
+        = headless_ ? offscreenTarget_->getImages() : vlkSwapchain_->getImages();
+    sceneTarget_->recordUpscale(
+        commandBuffer,
+        frameIndex_,
+        renderExtent,
+        images.at(imageIndex_),
+        imageExtent(),
+        graphicSettings_.upscaleFilter == UpscaleFilter::eNearest
+            ? vk::Filter::eNearest
+            : vk::Filter::eLinear,
+        dstLayout);
+    commandBuffer.end();
+
+    /* Executed first */
+    frame.commandBufferHandles_.insert(
+        frame.commandBufferHandles_.begin(), commandBuffer.getHandle());
+}
+
+FrameCommandPool& VulkanRenderingContext::threadCommandPool(FrameObjects& frame)
+{
+    const uint32_t threadIndex = JobSystem::threadIndex();
+    EXPENGINE_ASSERT(
+        threadIndex < frame.commandPools_.size(),
+        "Too many threads recording command buffers");
+
+    /* Each slot is only accessed by its own thread during the frame : the main
+     * thread uses slot 0, the render thread and the workers have their own index */
+    auto& pool = frame.commandPools_[threadIndex];
+    if (!pool)
+    {
+        pool = std::make_unique<FrameCommandPool>(
+            device_,
+            *renderPass_,
+            images_.at(imageIndex_).framebuffer_.get(),
+            imageExtent());
+    }
+    return *pool;
+}
+
+void VulkanRenderingContext::resetCommandPools(FrameObjects& frame)
+{
+    for (auto& pool : frame.commandPools_)
+    {
+        if (pool)
+            pool->reset(images_.at(imageIndex_).framebuffer_.get());
+    }
+    frame.commandBufferHandles_.clear();
+}
+
+vk::Format VulkanRenderingContext::imageFormat() const
+{
+    return headless_ ? offscreenTarget_->getSurfaceFormat().format
+                     : vlkSwapchain_->getSurfaceFormat().format;
+}
+
+vk::Extent2D VulkanRenderingContext::imageExtent() const
+{
+    return headless_ ? offscreenTarget_->getImageExtent()
+                     : vlkSwapchain_->getImageExtent();
+}
+
+void VulkanRenderingContext::recordReadback(FrameObjects& frame)
+{
+    /* From the pool of the recording thread, recycled in beginFrame */
+    auto& commandBuffer = threadCommandPool(frame).request();
+    commandBuffer.begin(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+    offscreenTarget_->recordReadback(commandBuffer, imageIndex_);
+    commandBuffer.end();
+    frame.commandBufferHandles_.push_back(commandBuffer.getHandle());
+
+    frame.pendingReadbackPath_ = fmt::format(
+        "{}/frame_{:06d}.ppm", readbackDirectory_, submittedFrames_);
+}
+
+void VulkanRenderingContext::writePendingReadback(uint32_t frameIndex)
+{
+    auto& frame = frames_.at(frameIndex);
+    if (frame.pendingReadbackPath_.empty())
+        return;
+
+    offscreenTarget_->writeReadback(frameIndex, frame.pendingReadbackPath_);
+    SPDLOG_LOGGER_DEBUG(logger_, "Frame written to {}", frame.pendingReadbackPath_);
+    frame.pendingReadbackPath_.clear();
 }
 
 } // namespace vlk
@@ -1,19 +1,31 @@
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <string>
 #include <vector>
 
+#include <engine/EngineParameters.hpp>
 #include <engine/render/RenderingContext.hpp>
 #include <engine/render/Window.hpp>
 #include <engine/render/vlk/VlkInclude.hpp>
+#include <engine/render/vlk/VlkPipelineRegistry.hpp>
 #include <engine/utils/Flags.hpp>
+#include <engine/utils/RenderScaleController.hpp>
 
 namespace experim {
+
+class HeadlessWindow;
+
 namespace vlk {
 
+class DescriptorAllocator;
+class OffscreenTarget;
+class SceneTarget;
 class Swapchain;
 class Device;
 class FrameCommandBuffer;
+class FrameCommandPool;
 class VulkanWindow;
 class MemoryAllocator;
 struct FrameObjects;
@@ -24,28 +36,78 @@ public:
         const Device& device,
         std::shared_ptr<VulkanWindow> window,
         AttachmentsFlags attachmentFlags,
+        uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT,
+        const GraphicSettings& graphicSettings = {},
+        std::function<void(void)> surfaceChangeCallback = nullptr);
+    /** Headless RenderingContext : renders into offscreen images instead of a
+     * swapchain. There is no surface and no presentation. */
+    VulkanRenderingContext(
+        const Device& device,
+        std::shared_ptr<HeadlessWindow> window,
+        AttachmentsFlags attachmentFlags,
+        uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT,
         std::function<void(void)> surfaceChangeCallback = nullptr);
     ~VulkanRenderingContext() override;
 
     /* Accessors */
     inline const vk::SurfaceKHR surface() const { return windowSurface_.get(); };
-    inline size_t imageCount() const { return frames_.size(); };
+    inline size_t imageCount() const { return images_.size(); };
+    /** Frames recorded by the CPU while the GPU renders the previous ones. Per
+     * frame resources are indexed by frame, not by swapchain image. */
+    inline uint32_t framesInFlight() const { return framesInFlight_; };
     inline const Window& window() const override;
+    inline bool isHeadless() const { return headless_; };
+    /** Timings of the latest frame completed by the GPU */
+    inline const GpuFrameTimings& gpuTimings() const { return gpuTimings_; };
+    /** Time (in ms) the latest beginFrame was blocked on the frame in flight and on
+     * the image acquisition */
+    inline double frameWaitDuration() const { return frameWaitDuration_; };
 
     /** Call to make the RenderingContext check its surface and adapt its objects to
      * it. */
     void handleSurfaceChanges() override;
-    /* Uses the implicit RC RenderPass */
-    vk::UniquePipeline createGraphicsPipeline(
-        vk::GraphicsPipelineCreateInfo& pipelineInfos);
+    /** Implicit RC RenderPass. Recreated with the swapchain, but stays compatible
+     * with its previous instances while renderPassCompatibility() is unchanged. */
+    inline vk::RenderPass renderPass() const { return renderPass_.get(); };
+    RenderPassCompatibility renderPassCompatibility() const;
 
     /* Frame rendering */
     void beginFrame() override;
     void submitFrame() override;
     /* TODO : should have a common buffer interfaces between backends */
     vlk::FrameCommandBuffer& requestCommandBuffer();
+    /** Returns a begun secondary command buffer, continuing the render pass of the
+     * frame. Can be called from any JobSystem thread between beginFrame and
+     * submitFrame : each thread records from its own command pool. Once ended, it
+     * must be executed by a primary command buffer whose render pass was begun
+     * with secondary contents. */
+    vlk::FrameCommandBuffer& requestSecondaryCommandBuffer();
+    /** Allocator of the current frame, for descriptor sets made of one combined
+     * image sampler. Its sets are all freed when the frame is reused : no
+     * individual free. */
+    vlk::DescriptorAllocator& transientDescriptorAllocator();
+
+    /** Rebuilds the frame objects when the count changes, like a surface change.
+     * Clamped to [1, MAX_FRAMES_IN_FLIGHT]. Not during a frame. */
+    void setFramesInFlight(uint32_t framesInFlight);
 
+    /** Rebuilds the swapchain when the present mode or the min image count
+     * changes (ignored when headless), or when dynamic resolution is toggled. Not
+     * during a frame. */
+    void setGraphicSettings(const GraphicSettings& graphicSettings);
+    /** Effective present mode and image counts of the swapchain */
+    PresentationInfo presentation() const;
+
+    /** Headless only. Every frameInterval frames, the rendered image is read back
+     * and written to directory as a PPM file. An interval of 0 disables it. */
+    void setReadback(const std::string& directory, uint32_t frameInterval);
+
+    /** Waits for the frames of this RenderingContext only */
     void waitIdle();
+    /** Graphics timeline value of the latest frame submitted by this context. The
+     * objects used by its frames can be released to the device DeletionQueue with
+     * it. */
+    inline uint64_t submittedValue() const { return submittedValue_; };
 
     std::shared_ptr<RenderingContext> clone(
         std::shared_ptr<Window> window,
@@ -53,53 +115,114 @@ public:
 
 private:
     /* Types */
+    /* Per frame in flight. Headless : frame i renders into offscreen image i. */
     struct FrameObjects {
-        vk::UniqueFence fence_;
-        vk::UniqueImageView imageView_;
-        vk::UniqueFramebuffer framebuffer_;
-        /* TODO Pool implementation/rework */
-        vk::UniqueCommandPool commandPool_;
-        std::vector<FrameCommandBuffer> commandBuffers_;
+        /* Graphics timeline value of the latest submission, 0 before the first */
+        uint64_t submittedValue_;
+        /* Windowed only. Free again once submittedValue_ is reached. */
+        vk::UniqueSemaphore imageAcquired_;
+        /* Indexed by JobSystem::threadIndex(), null until the thread records. 0 is
+         * the main thread, the render thread is registered with the JobSystem. */
+        std::vector<std::unique_ptr<FrameCommandPool>> commandPools_;
+        /* Submitted in order. Keeps its capacity across frames. */
         std::vector<vk::CommandBuffer> commandBufferHandles_;
+        /* Reset with the command pools */
+        std::unique_ptr<DescriptorAllocator> transientDescriptors_;
+        /* Empty when no readback is waiting for the frame completion */
+        std::string pendingReadbackPath_;
+        /* 2 timestamps per render pass, read once the frame is complete */
+        vk::UniqueQueryPool timestampPool_;
+        uint32_t timestampQueryCount_;
+        /* First query of the scaled scene pass, NO_SCENE_QUERY if not timed */
+        uint32_t sceneTimestampQuery_;
     };
 
-    struct FrameSemaphores {
-        vk::UniqueSemaphore imageAcquired_;
+    /* Per swapchain or offscreen image */
+    struct ImageObjects {
+        vk::UniqueImageView imageView_;
+        vk::UniqueFramebuffer framebuffer_;
+        /* Windowed only. Waited by the presentation : it is free again once the
+         * image is acquired anew. */
         vk::UniqueSemaphore renderComplete_;
     };
 
+    /* Replaced by a surface change, destroyed once the GPU is done with them */
+    struct RetiredSwapchainObjects {
+        std::vector<FrameObjects> frames_;
+        std::vector<ImageObjects> images_;
+        std::unique_ptr<vlk::Swapchain> swapchain_;
+        std::unique_ptr<vlk::SceneTarget> sceneTarget_;
+        vk::UniqueRenderPass renderPass_;
+        /* submittedFrames_ at retirement */
+        uint64_t retiredFrame_;
+        /* Graphics timeline value of the last submission of frames_ */
+        uint64_t submittedValue_;
+    };
+
+    /* Released to the DeletionQueue on destruction. Destroyed in reverse order :
+     * the window outlives its surface and swapchain. */
+    struct ReleasedContextObjects {
+        std::shared_ptr<const Window> window_;
+        vk::UniqueSurfaceKHR windowSurface_;
+        std::unique_ptr<vlk::Swapchain> vlkSwapchain_;
+        std::unique_ptr<vlk::SceneTarget> sceneTarget_;
+        vk::UniqueRenderPass renderPass_;
+        std::deque<RetiredSwapchainObjects> retiredObjects_;
+        std::vector<ImageObjects> images_;
+        std::vector<FrameObjects> frames_;
+    };
+
     /* References */
     const Device& device_;
 
     /* Configuration */
     AttachmentsFlags attachmentsFlags_;
+    const bool headless_;
+    uint32_t framesInFlight_;
+    GraphicSettings graphicSettings_;
 
     /* Owned objects */
-    std::shared_ptr<const vlk::VulkanWindow> window_;
+    std::shared_ptr<const Window> window_;
     vk::UniqueSurfaceKHR windowSurface_;
+    /* Only one of them is used, depending on headless_ */
     std::unique_ptr<vlk::Swapchain> vlkSwapchain_;
+    std::unique_ptr<vlk::OffscreenTarget> offscreenTarget_;
+    /* Null unless the resolution is dynamic */
+    std::unique_ptr<vlk::SceneTarget> sceneTarget_;
     vk::UniqueRenderPass renderPass_;
 
     /* Frames */
+    /* Round-robin over frames_ */
     uint32_t frameIndex_;
-    uint32_t semaphoreIndex_;
+    /* Acquired image of the current frame */
+    uint32_t imageIndex_;
     std::vector<FrameObjects> frames_;
-    std::vector<FrameSemaphores> semaphores_;
-    /* Mapping to know which frame is using which semaphore group.
-     * Semaphore Group ID -> Frame Fence
-     * We can wait on the fence to make sure that the semaphore group is available */
-    std::unordered_map<uint32_t, vk::Fence> semaphoreToFrameFence_;
+    std::vector<ImageObjects> images_;
+    /* Oldest first */
+    std::deque<RetiredSwapchainObjects> retiredObjects_;
+
+    /* GPU timings */
+    GpuFrameTimings gpuTimings_;
+    double frameWaitDuration_;
+    /* Dynamic resolution, fed with the GPU timings */
+    RenderScaleController renderScale_;
+
+    /* Headless readback */
+    std::string readbackDirectory_;
+    uint32_t readbackInterval_;
+    uint64_t submittedFrames_;
+    uint64_t submittedValue_;
 
     /* Objects creation */
     vk::UniqueRenderPass createRenderPass(
         const vlk::Device& device,
-        const vlk::Swapchain& swapchain,
+        vk::Format imageFormat,
         AttachmentsFlags attachmentsFlags);
-    void createFrameObjects(
-        std::vector<FrameObjects>& frames,
-        const vlk::Swapchain& swapchain,
-        vk::RenderPass& renderPass,
+    void createImageObjects(
+        const std::vector<vk::Image>& images,
+        vk::RenderPass renderPass,
         AttachmentsFlags attachmentsFlags);
+    void createFrameObjects();
     /* Called once at creation. Should also be called on each resize.
      * Reads the new image/surface size from the window directly.
      * Does the following :
@@ -114,6 +237,41 @@ private:
     void buildSwapchainObjects(
         vk::Extent2D requestedExtent,
         vk::SwapchainKHR oldSwapchainHandle = nullptr);
+    /* Rebuilds the objects of a running context, then calls the surface change
+     * callback */
+    void rebuildSwapchainObjects(vk::Extent2D requestedExtent);
+
+    /* Moves the swapchain objects to retiredObjects_ instead of waiting for them.
+     * The old swapchain is kept alive for the creation of the new one. */
+    void retireSwapchainObjects();
+    /* Destroys the retired objects the GPU is done with. Does not wait. */
+    void releaseRetiredObjects();
+
+    /* Properties of the swapchain or offscreen images */
+    vk::Format imageFormat() const;
+    vk::Extent2D imageExtent() const;
+
+    /* Command pool of the calling thread for frame, created on first use */
+    FrameCommandPool& threadCommandPool(FrameObjects& frame);
+    void resetCommandPools(FrameObjects& frame);
+
+    /* Blocks until the previous submission of frame is complete */
+    void waitForFrame(const FrameObjects& frame);
+    /* Reads the timestamps written by the previous use of the frame. It must be
+     * complete. Returns false when no new timings were read. */
+    bool readTimestamps(FrameObjects& frame);
+
+    /* Dynamic resolution */
+    void configureRenderScale();
+    /* Feeds the timings of the latest completed frame to renderScale_ */
+    void updateRenderScale();
+    /* Records the scene and its upscale, executed before the other command
+     * buffers of the frame */
+    void recordScene(FrameObjects& frame);
+
+    /* Headless readback */
+    void recordReadback(FrameObjects& frame);
+    void writePendingReadback(uint32_t frameIndex);
 };
 
 } // namespace vlk
@@ -0,0 +1,245 @@
+#include "VlkSceneTarget.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <engine/log/ExpengineLog.hpp>
+#include <engine/render/vlk/VlkCommandBuffer.hpp>
+#include <engine/render/vlk/VlkDebug.hpp>
+#include <engine/render/vlk/VlkDevice.hpp>
+#include <engine/render/vlk/VlkMemoryAllocator.hpp>
+#include <engine/render/vlk/resources/VlkImage.hpp>
+
+namespace {
+
+const vk::FormatFeatureFlags SCENE_FORMAT_FEATURES
+    = vk::FormatFeatureFlagBits::eColorAttachment
+    | vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst;
+
+const vk::ImageSubresourceRange COLOR_SUBRESOURCE_RANGE
+    = {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1};
+const vk::ImageSubresourceLayers COLOR_SUBRESOURCE_LAYERS
+    = {vk::ImageAspectFlagBits::eColor, 0, 0, 1};
+
+} // namespace
+
+namespace experim {
+namespace vlk {
+
+SceneTarget::SceneTarget(
+    const vlk::Device& device,
+    vk::Format format,
+    vk::Extent2D extent,
+    uint32_t imageCount)
+    : device_(device)
+    , format_(format)
+    , extent_(extent)
+    , logger_(spdlog::get(LOGGER_NAME))
+{
+    createRenderPass();
+
+    for (uint32_t i = 0; i < imageCount; i++)
+    {
+        auto image = device_.allocator().createImage(
+            VMA_MEMORY_USAGE_GPU_ONLY,
+            vk::ImageUsageFlagBits::eColorAttachment
+                | vk::ImageUsageFlagBits::eTransferSrc,
+            format_,
+            extent_.width,
+            extent_.height);
+
+        auto [imageViewResult, imageView]
+            = device_.deviceHandle().createImageViewUnique(
+                {.image = image->getHandle(),
+                 .viewType = vk::ImageViewType::e2D,
+                 .format = format_,
+                 .components
+                 = {.r = vk::ComponentSwizzle::eR,
+                    .g = vk::ComponentSwizzle::eG,
+                    .b = vk::ComponentSwizzle::eB,
+                    .a = vk::ComponentSwizzle::eA},
+                 .subresourceRange = COLOR_SUBRESOURCE_RANGE});
+        EXPENGINE_VK_ASSERT(imageViewResult, "Failed to create an image view");
+
+        auto [framebufferResult, framebuffer]
+            = device_.deviceHandle().createFramebufferUnique(
+                {.renderPass = renderPass_.get(),
+                 .attachmentCount = 1,
+                 .pAttachments = &imageView.get(),
+                 .width = extent_.width,
+                 .height = extent_.height,
+                 .layers = 1});
+        EXPENGINE_VK_ASSERT(framebufferResult, "Failed to create a framebuffer");
+
+        images_.push_back(std::move(image));
+        imageViews_.push_back(std::move(imageView));
+        framebuffers_.push_back(std::move(framebuffer));
+    }
+
+    SPDLOG_LOGGER_DEBUG(
+        logger_,
+        "SceneTarget created : {} image(s) of {}x{}",
+        imageCount,
+        extent_.width,
+        extent_.height);
+}
+
+SceneTarget::~SceneTarget()
+{
+    SPDLOG_LOGGER_DEBUG(logger_, "SceneTarget destruction");
+}
+
+bool SceneTarget::isFormatSupported(const vlk::Device& device, vk::Format format)
+{
+    auto properties = device.physicalHandle().getFormatProperties(format);
+    return (properties.optimalTilingFeatures & SCENE_FORMAT_FEATURES)
+        == SCENE_FORMAT_FEATURES;
+}
+
+vk::Extent2D SceneTarget::getScaledExtent(float scale) const
+{
+    return vk::Extent2D {
+        .width = std::clamp(
+            static_cast<uint32_t>(std::lround(extent_.width * scale)),
+            1u,
+            extent_.width),
+        .height = std::clamp(
+            static_cast<uint32_t>(std::lround(extent_.height * scale)),
+            1u,
+            extent_.height)};
+}
+
+void SceneTarget::recordScenePass(
+    CommandBuffer& commandBuffer,
+    uint32_t imageIndex,
+    vk::Extent2D renderExtent)
+{
+    std::array<float, 4> clearValue = {0.0f, 0.0f, 0.0f, 1.0f};
+    vk::ClearValue clearColor(clearValue);
+    commandBuffer.getHandle().beginRenderPass(
+        {.renderPass = renderPass_.get(),
+         .framebuffer = framebuffers_.at(imageIndex).get(),
+         .renderArea = {.extent = renderExtent},
+         .clearValueCount = 1,
+         .pClearValues = &clearColor},
+        vk::SubpassContents::eInline);
+    /* TODO Scene rendering here, with a viewport of renderExtent */
+    commandBuffer.getHandle().endRenderPass();
+}
+
+void SceneTarget::recordUpscale(
+    CommandBuffer& commandBuffer,
+    uint32_t imageIndex,
+    vk::Extent2D renderExtent,
+    vk::Image dstImage,
+    vk::Extent2D dstExtent,
+    vk::Filter filter,
+    vk::ImageLayout dstFinalLayout)
+{
+    /* The render pass external dependency does not cover transfer reads */
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eColorAttachmentOutput,
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::MemoryBarrier {
+            .srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferRead});
+    /* The whole image is overwritten : its previous content is discarded. For a
+     * swapchain image, the image acquisition is waited on at the transfer
+     * stage. */
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::ImageMemoryBarrier {
+            .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .oldLayout = vk::ImageLayout::eUndefined,
+            .newLayout = vk::ImageLayout::eTransferDstOptimal,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = dstImage,
+            .subresourceRange = COLOR_SUBRESOURCE_RANGE});
+
+    vk::ImageBlit region {
+        .srcSubresource = COLOR_SUBRESOURCE_LAYERS,
+        .srcOffsets = std::array<vk::Offset3D, 2> {
+            vk::Offset3D {0, 0, 0},
+            vk::Offset3D {
+                static_cast<int32_t>(renderExtent.width),
+                static_cast<int32_t>(renderExtent.height),
+                1}},
+        .dstSubresource = COLOR_SUBRESOURCE_LAYERS,
+        .dstOffsets = std::array<vk::Offset3D, 2> {
+            vk::Offset3D {0, 0, 0},
+            vk::Offset3D {
+                static_cast<int32_t>(dstExtent.width),
+                static_cast<int32_t>(dstExtent.height),
+                1}}};
+    commandBuffer.blitImage(
+        images_.at(imageIndex)->getHandle(), dstImage, region, filter);
+
+    /* Ready for the next render pass, or for the final use of the image */
+    vk::PipelineStageFlags dstStage = vk::PipelineStageFlagBits::eBottomOfPipe;
+    vk::AccessFlags dstAccess;
+    if (dstFinalLayout == vk::ImageLayout::eColorAttachmentOptimal)
+    {
+        dstStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+        dstAccess = vk::AccessFlagBits::eColorAttachmentRead
+            | vk::AccessFlagBits::eColorAttachmentWrite;
+    }
+    else if (dstFinalLayout == vk::ImageLayout::eTransferSrcOptimal)
+    {
+        dstStage = vk::PipelineStageFlagBits::eTransfer;
+        dstAccess = vk::AccessFlagBits::eTransferRead;
+    }
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        dstStage,
+        vk::ImageMemoryBarrier {
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = dstAccess,
+            .oldLayout = vk::ImageLayout::eTransferDstOptimal,
+            .newLayout = dstFinalLayout,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = dstImage,
+            .subresourceRange = COLOR_SUBRESOURCE_RANGE});
+}
+
+void SceneTarget::createRenderPass()
+{
+    vk::AttachmentDescription colorAttachment {
+        .format = format_,
+        .samples = vk::SampleCountFlagBits::e1,
+        .loadOp = vk::AttachmentLoadOp::eClear,
+        .storeOp = vk::AttachmentStoreOp::eStore,
+        .stencilLoadOp = vk::AttachmentLoadOp::eDontCare,
+        .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
+        .initialLayout = vk::ImageLayout::eUndefined,
+        /* Only read by the upscale */
+        .finalLayout = vk::ImageLayout::eTransferSrcOptimal};
+    vk::AttachmentReference colorAttachmentRef {
+        .attachment = 0, .layout = vk::ImageLayout::eColorAttachmentOptimal};
+    vk::SubpassDescription subpass {
+        .pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
+        .colorAttachmentCount = 1,
+        .pColorAttachments = &colorAttachmentRef};
+    vk::SubpassDependency dependency {
+        .srcSubpass = VK_SUBPASS_EXTERNAL,
+        .dstSubpass = 0,
+        .srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput,
+        .dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput,
+        .dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite};
+
+    auto [result, renderPass] = device_.deviceHandle().createRenderPassUnique(
+        {.attachmentCount = 1,
+         .pAttachments = &colorAttachment,
+         .subpassCount = 1,
+         .pSubpasses = &subpass,
+         .dependencyCount = 1,
+         .pDependencies = &dependency});
+    EXPENGINE_VK_ASSERT(result, "Failed to create the scene render pass");
+    renderPass_ = std::move(renderPass);
+}
+
+} // namespace vlk
+} // namespace experim
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <engine/render/vlk/VlkInclude.hpp>
+
+namespace spdlog {
+class logger;
+}
+
+namespace experim {
+namespace vlk {
+
+class CommandBuffer;
+class Device;
+class VlkImage;
+
+/** Dynamic resolution : the scene of a RenderingContext is rendered into one of
+ * these images, at a scaled extent, then upscaled into the presented image before
+ * the UI is rendered on top of it. The images are allocated at the full extent, so
+ * that a scale change does not reallocate them : only a corner is rendered to. One
+ * image per frame in flight. */
+class SceneTarget {
+public:
+    SceneTarget(
+        const vlk::Device& device,
+        vk::Format format,
+        vk::Extent2D extent,
+        uint32_t imageCount);
+    ~SceneTarget();
+
+    /** Whether images of format can be rendered to and blitted */
+    static bool isFormatSupported(const vlk::Device& device, vk::Format format);
+
+    inline const vk::Extent2D& getExtent() const { return extent_; }
+    inline vk::RenderPass getRenderPass() const { return renderPass_.get(); };
+    /** Extent rendered at scale, at least 1 pixel */
+    vk::Extent2D getScaledExtent(float scale) const;
+
+    /** Renders the scene of imageIndex, in the top-left corner of the image. The
+     * scene is not implemented yet : the render pass only clears it. */
+    void recordScenePass(
+        CommandBuffer& commandBuffer,
+        uint32_t imageIndex,
+        vk::Extent2D renderExtent);
+    /** Upscales the rendered corner of imageIndex to the whole dstImage, whose
+     * previous content is discarded. dstImage is left in the
+     * ColorAttachmentOptimal layout, or in dstFinalLayout when not rendered to
+     * afterwards. */
+    void recordUpscale(
+        CommandBuffer& commandBuffer,
+        uint32_t imageIndex,
+        vk::Extent2D renderExtent,
+        vk::Image dstImage,
+        vk::Extent2D dstExtent,
+        vk::Filter filter,
+        vk::ImageLayout dstFinalLayout);
+
+private:
+    /* References */
+    const vlk::Device& device_;
+
+    /* Properties */
+    vk::Format format_;
+    vk::Extent2D extent_;
+
+    /* Owned objects */
+    vk::UniqueRenderPass renderPass_;
+    std::vector<std::unique_ptr<VlkImage>> images_;
+    std::vector<vk::UniqueImageView> imageViews_;
+    std::vector<vk::UniqueFramebuffer> framebuffers_;
+
+    /* Logging */
+    std::shared_ptr<spdlog::logger> logger_;
+
+    void createRenderPass();
+};
+
+} // namespace vlk
+} // namespace experim
@@ -0,0 +1,77 @@
+#include "VlkStagingRing.hpp"
+
+#include <engine/render/vlk/VlkDebug.hpp>
+#include <engine/render/vlk/VlkMemoryAllocator.hpp>
+#include <engine/render/vlk/resources/VlkBuffer.hpp>
+
+namespace experim {
+namespace vlk {
+
+StagingRing::StagingRing(const MemoryAllocator& allocator, vk::DeviceSize capacity)
+    : capacity_(capacity)
+    , head_(0)
+    , usedBytes_(0)
+    , batchBytes_(0)
+{
+    /* CPU_ONLY memory is host visible and coherent */
+    buffer_ = allocator.createStagingBuffer(capacity_);
+    buffer_->assertMap();
+    mapped_ = static_cast<uint8_t*>(buffer_->mappedData());
+}
+
+StagingRing::~StagingRing() { buffer_->unmap(); }
+
+std::optional<StagingRegion> StagingRing::allocate(
+    vk::DeviceSize size,
+    vk::DeviceSize alignment)
+{
+    if (size > capacity_)
+        return std::nullopt;
+
+    vk::DeviceSize offset = (head_ + alignment - 1) / alignment * alignment;
+    vk::DeviceSize padding = offset - head_;
+    if (offset + size > capacity_)
+    {
+        /* Wrap around : the end of the buffer is wasted until the batch is
+         * released */
+        offset = 0;
+        padding = capacity_ - head_;
+    }
+    /* Regions are released in order : the used bytes are contiguous from the
+     * oldest region to the head */
+    if (usedBytes_ + padding + size > capacity_)
+        return std::nullopt;
+
+    head_ = offset + size;
+    usedBytes_ += padding + size;
+    batchBytes_ += padding + size;
+
+    return StagingRegion {
+        .buffer = buffer_->getHandle(),
+        .offset = offset,
+        .size = size,
+        .data = mapped_ + offset};
+}
+
+void StagingRing::closeBatch(uint64_t batchId)
+{
+    if (batchBytes_ == 0)
+        return;
+    closedBatches_.push_back({.id = batchId, .bytes = batchBytes_});
+    batchBytes_ = 0;
+}
+
+void StagingRing::releaseBatches(uint64_t batchId)
+{
+    while (!closedBatches_.empty() && closedBatches_.front().id <= batchId)
+    {
+        usedBytes_ -= closedBatches_.front().bytes;
+        closedBatches_.pop_front();
+    }
+    /* Restart from the beginning when empty, to keep the regions contiguous */
+    if (usedBytes_ == 0)
+        head_ = 0;
+}
+
+} // namespace vlk
+} // namespace experim
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+
+#include <engine/render/vlk/VlkInclude.hpp>
+
+namespace experim {
+namespace vlk {
+
+class Buffer;
+class MemoryAllocator;
+
+/** Region of the staging ring, written by the host then read by a transfer */
+struct StagingRegion {
+    vk::Buffer buffer;
+    vk::DeviceSize offset;
+    vk::DeviceSize size;
+    /* Mapped address of the region */
+    uint8_t* data;
+};
+
+/**
+ * Persistently mapped host buffer, sub-allocated as a ring. Regions are released
+ * in allocation order, by batches : allocate() the regions of a batch, close it
+ * once its transfers are submitted, and release it once they are executed. The
+ * memory is host coherent : no flush needed.
+ *
+ * Not thread-safe : owned by the Uploader.
+ */
+class StagingRing {
+public:
+    StagingRing(const MemoryAllocator& allocator, vk::DeviceSize capacity);
+    ~StagingRing();
+
+    /** Empty if there is not enough contiguous free space : release a batch and
+     * retry. Never succeeds when size > capacity(). */
+    std::optional<StagingRegion> allocate(
+        vk::DeviceSize size,
+        vk::DeviceSize alignment);
+    /** Regions allocated since the last call belong to the batch batchId */
+    void closeBatch(uint64_t batchId);
+    /** Frees the regions of the closed batches up to batchId (included) */
+    void releaseBatches(uint64_t batchId);
+
+    inline vk::DeviceSize capacity() const { return capacity_; };
+    /** Bytes in use, alignment padding included */
+    inline vk::DeviceSize usedBytes() const { return usedBytes_; };
+
+private:
+    struct ClosedBatch {
+        uint64_t id;
+        vk::DeviceSize bytes;
+    };
+
+    /* Owned objects */
+    std::unique_ptr<Buffer> buffer_;
+    uint8_t* mapped_;
+
+    /* Ring */
+    const vk::DeviceSize capacity_;
+    vk::DeviceSize head_;
+    vk::DeviceSize usedBytes_;
+    /* Bytes allocated since the last closed batch */
+    vk::DeviceSize batchBytes_;
+    std::deque<ClosedBatch> closedBatches_;
+};
+
+} // namespace vlk
+} // namespace experim
@@ -16,16 +16,32 @@ const std::vector<vk::SurfaceFormatKHR> SURFACE_FORMATS_PRIORITY_LIST
        {vk::Format::eR8G8B8A8Unorm, vk::ColorSpaceKHR::eSrgbNonlinear},
        {vk::Format::eB8G8R8A8Unorm, vk::ColorSpaceKHR::eSrgbNonlinear}};
 
-/* Preferred present modes (from most to least).
+/* Fallbacks of each present mode (from most to least preferred).
  * VK_PRESENT_MODE_MAILBOX_KHR allow for triple buffering and limited
  * latency.
  * VK_PRESENT_MODE_IMMEDIATE_KHR for minimal latency
- * VK_PRESENT_MODE_FIFO_KHR double buffering with some latency
+ * VK_PRESENT_MODE_FIFO_KHR double buffering with some latency, always available
  */
-std::vector<vk::PresentModeKHR> PRESENT_MODE_PRIORITY_LIST
-    = {vk::PresentModeKHR::eMailbox,
-       vk::PresentModeKHR::eImmediate,
-       vk::PresentModeKHR::eFifo};
+std::vector<vk::PresentModeKHR> presentModePriorityList(
+    vk::PresentModeKHR requestedMode)
+{
+    switch (requestedMode)
+    {
+    case vk::PresentModeKHR::eMailbox:
+        return {
+            vk::PresentModeKHR::eMailbox,
+            vk::PresentModeKHR::eImmediate,
+            vk::PresentModeKHR::eFifo};
+    case vk::PresentModeKHR::eImmediate:
+        return {
+            vk::PresentModeKHR::eImmediate,
+            vk::PresentModeKHR::eMailbox,
+            vk::PresentModeKHR::eFifo};
+    default:
+        /* Vsync requested : never fall back to a tearing mode */
+        return {requestedMode, vk::PresentModeKHR::eFifo};
+    }
+}
 
 } // namespace
 
@@ -36,6 +52,8 @@ Swapchain::Swapchain(
     const vlk::Device& device,
     vk::SurfaceKHR& surface,
     vk::Extent2D requestedExtent,
+    vk::PresentModeKHR requestedPresentMode,
+    uint32_t requestedMinImageCount,
     vk::SwapchainKHR oldSwapchainHandle)
     : device_(device)
     , surface_(surface)
@@ -58,11 +76,10 @@ Swapchain::Swapchain(
         swapchainSupport.formats,
         SURFACE_FORMATS_PRIORITY_LIST);
     /* Select the best Present Mode available */
-    /* Request mailbox for now but should enable Vsync toggle */
     presentMode_ = chooseSwapPresentMode(
-        vk::PresentModeKHR::eMailbox,
+        requestedPresentMode,
         swapchainSupport.presentModes,
-        PRESENT_MODE_PRIORITY_LIST);
+        presentModePriorityList(requestedPresentMode));
     /* Select the Swap Extent */
     imageExtent_ = chooseSwapExtent(
         requestedExtent,
@@ -71,14 +88,15 @@ Swapchain::Swapchain(
         swapchainSupport.capabilities.maxImageExtent);
 
     /* Chose min image count */
-    uint32_t requestedMinImageCount
-        = swapchainSupport.capabilities.minImageCount + 1;
-    /* A value of 0 for maxImageCount means that there is no limit besides
-     * memory requirements. */
-    if (swapchainSupport.capabilities.maxImageCount > 0
-        && requestedMinImageCount > swapchainSupport.capabilities.maxImageCount)
+    minImageCount_ = chooseMinImageCount(
+        requestedMinImageCount, swapchainSupport.capabilities);
+
+    /* Rendered to, and upscaled to when the resolution is dynamic */
+    imageUsage_ = vk::ImageUsageFlagBits::eColorAttachment;
+    if (swapchainSupport.capabilities.supportedUsageFlags
+        & vk::ImageUsageFlagBits::eTransferDst)
     {
-        requestedMinImageCount = swapchainSupport.capabilities.maxImageCount;
+        imageUsage_ |= vk::ImageUsageFlagBits::eTransferDst;
     }
 
     /* Chose image sharing mode */
@@ -100,13 +118,12 @@ Swapchain::Swapchain(
     /* Create SwapChain */
     vk::SwapchainCreateInfoKHR createInfo {
         .surface = surface,
-        .minImageCount = requestedMinImageCount,
+        .minImageCount = minImageCount_,
         .imageFormat = surfaceFormat_.format,
         .imageColorSpace = surfaceFormat_.colorSpace,
         .imageExtent = imageExtent_,
         .imageArrayLayers = 1,
-        /* Render directly, no post-processsing */
-        .imageUsage = vk::ImageUsageFlagBits::eColorAttachment,
+        .imageUsage = imageUsage_,
         .imageSharingMode = imageSharingMode,
         .queueFamilyIndexCount = queueFamilyIndexCount,
         .pQueueFamilyIndices = pQueueFamilyIndices,
@@ -266,6 +283,7 @@ vk::PresentModeKHR Swapchain::chooseSwapPresentMode(
                 != availablePresentModes.end())
             {
                 selectedMode = presentMode;
+                break;
             }
         }
         SPDLOG_LOGGER_WARN(
@@ -287,6 +305,31 @@ vk::PresentModeKHR Swapchain::chooseSwapPresentMode(
     return vk::PresentModeKHR();
 }
 
+uint32_t Swapchain::chooseMinImageCount(
+    uint32_t requestedMinImageCount,
+    const vk::SurfaceCapabilitiesKHR& capabilities) const
+{
+    /* One more image than the minimum by default, so that the application does not
+     * wait on the presentation engine to acquire an image */
+    uint32_t minImageCount = requestedMinImageCount > 0
+        ? requestedMinImageCount
+        : capabilities.minImageCount + 1;
+    minImageCount = std::max(minImageCount, capabilities.minImageCount);
+    /* A value of 0 for maxImageCount means that there is no limit besides
+     * memory requirements. */
+    if (capabilities.maxImageCount > 0 && minImageCount > capabilities.maxImageCount)
+    {
+        minImageCount = capabilities.maxImageCount;
+    }
+
+    SPDLOG_LOGGER_DEBUG(
+        logger_,
+        "Swapchain : min image count '{}' selected, requested '{}'",
+        minImageCount,
+        requestedMinImageCount);
+    return minImageCount;
+}
+
 vk::Extent2D Swapchain::chooseSwapExtent(
     vk::Extent2D requestedExtent,
     vk::Extent2D currentExtent,
@@ -19,6 +19,8 @@ public:
         const vlk::Device& device,
         vk::SurfaceKHR& surface,
         vk::Extent2D requestedExtent,
+        vk::PresentModeKHR requestedPresentMode,
+        uint32_t requestedMinImageCount = 0,
         vk::SwapchainKHR oldSwapchainHandle = nullptr);
     ~Swapchain();
 
@@ -32,6 +34,9 @@ public:
     {
         return surfaceFormat_;
     }
+    inline const vk::PresentModeKHR getPresentMode() const { return presentMode_; }
+    inline const uint32_t getMinImageCount() const { return minImageCount_; }
+    inline const vk::ImageUsageFlags getImageUsage() const { return imageUsage_; }
     inline const uint32_t getImageCount() const
     {
         return static_cast<uint32_t>(images_.size());
@@ -54,6 +59,8 @@ private:
     /* Swapchain properties */
     vk::SurfaceFormatKHR surfaceFormat_;
     vk::PresentModeKHR presentMode_;
+    uint32_t minImageCount_;
+    vk::ImageUsageFlags imageUsage_;
     vk::Extent2D imageExtent_;
     /* Extent that was requested when creating the swapchain. May not be the same as
      * the actual extent (imageExtent_) */
@@ -73,6 +80,9 @@ private:
         vk::PresentModeKHR requestedMode,
         const std::vector<vk::PresentModeKHR> availablePresentModes,
         const std::vector<vk::PresentModeKHR>& presentModePriorityList) const;
+    uint32_t chooseMinImageCount(
+        uint32_t requestedMinImageCount,
+        const vk::SurfaceCapabilitiesKHR& capabilities) const;
     vk::Extent2D chooseSwapExtent(
         vk::Extent2D requestedExtent,
         vk::Extent2D currentExtent,
@@ -0,0 +1,142 @@
+#include "VlkTextureTable.hpp"
+
+#include <engine/log/ExpengineLog.hpp>
+#include <engine/render/vlk/VlkCapabilities.hpp>
+#include <engine/render/vlk/VlkDebug.hpp>
+#include <engine/render/vlk/VlkDescriptorAllocator.hpp>
+#include <engine/render/vlk/VlkDevice.hpp>
+
+namespace experim {
+namespace vlk {
+
+TextureTable::TextureTable(const vlk::Device& device, bool allowBindless)
+    : device_(device)
+    , bindless_(allowBindless && device.hasBindlessTextures())
+    , nextHandle_(0)
+    , logger_(spdlog::get(LOGGER_NAME))
+{
+    if (bindless_)
+        createBindlessObjects();
+    else
+        createFallbackObjects();
+}
+
+TextureTable::~TextureTable()
+{
+    SPDLOG_LOGGER_DEBUG(logger_, "TextureTable destruction");
+}
+
+TextureTable::Handle TextureTable::registerTexture(
+    const vk::DescriptorImageInfo& imageInfo)
+{
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+
+    Handle handle;
+    if (!freeHandles_.empty())
+    {
+        handle = freeHandles_.back();
+        freeHandles_.pop_back();
+    }
+    else
+    {
+        EXPENGINE_ASSERT(
+            !bindless_ || nextHandle_ < BINDLESS_TEXTURE_COUNT,
+            "Bindless texture table is full");
+        handle = nextHandle_++;
+        /* Sets can't be freed : they are kept for the reuse of their handle */
+        if (!bindless_)
+        {
+            textureSets_.push_back(
+                device_.descriptorAllocator().allocate(*descriptorSetLayout_));
+        }
+    }
+
+    vk::WriteDescriptorSet writeDesc {
+        .dstSet = bindless_ ? bindlessSet_ : textureSets_.at(handle),
+        .dstArrayElement = bindless_ ? handle : 0,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+        .pImageInfo = &imageInfo};
+    device_.deviceHandle().updateDescriptorSets(writeDesc, nullptr);
+
+    return handle;
+}
+
+void TextureTable::unregisterTexture(Handle handle)
+{
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    EXPENGINE_ASSERT(handle < nextHandle_, "Invalid texture handle");
+    /* Bindless : the descriptor is left as is, partially bound arrays allow it
+     * since it is not used anymore */
+    freeHandles_.push_back(handle);
+}
+
+vk::DescriptorSet TextureTable::descriptorSet(Handle handle) const
+{
+    if (bindless_)
+        return bindlessSet_;
+
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    return textureSets_.at(handle);
+}
+
+void TextureTable::createBindlessObjects()
+{
+    /* Written while bound or in use by pending frames, and never fully written */
+    const vk::DescriptorBindingFlagsEXT bindingFlags
+        = vk::DescriptorBindingFlagBitsEXT::eUpdateAfterBind
+        | vk::DescriptorBindingFlagBitsEXT::eUpdateUnusedWhilePending
+        | vk::DescriptorBindingFlagBitsEXT::ePartiallyBound;
+    vk::DescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo {
+        .bindingCount = 1, .pBindingFlags = &bindingFlags};
+
+    vk::DescriptorSetLayoutBinding binding {
+        .binding = 0,
+        .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+        .descriptorCount = BINDLESS_TEXTURE_COUNT,
+        .stageFlags = vk::ShaderStageFlagBits::eFragment};
+    auto [layoutResult, layout]
+        = device_.deviceHandle().createDescriptorSetLayoutUnique(
+            {.pNext = &bindingFlagsInfo,
+             .flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPoolEXT,
+             .bindingCount = 1,
+             .pBindings = &binding});
+    EXPENGINE_VK_ASSERT(layoutResult, "Failed to create the bindless set layout");
+    descriptorSetLayout_ = std::move(layout);
+
+    vk::DescriptorPoolSize poolSize {
+        .type = vk::DescriptorType::eCombinedImageSampler,
+        .descriptorCount = BINDLESS_TEXTURE_COUNT};
+    auto [poolResult, pool] = device_.deviceHandle().createDescriptorPoolUnique(
+        {.flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBindEXT,
+         .maxSets = 1,
+         .poolSizeCount = 1,
+         .pPoolSizes = &poolSize});
+    EXPENGINE_VK_ASSERT(poolResult, "Failed to create the bindless descriptor pool");
+    bindlessPool_ = std::move(pool);
+
+    vk::DescriptorSetAllocateInfo allocateInfo {
+        .descriptorPool = bindlessPool_.get(),
+        .descriptorSetCount = 1,
+        .pSetLayouts = &descriptorSetLayout_.get()};
+    auto setResult = device_.deviceHandle().allocateDescriptorSets(
+        &allocateInfo, &bindlessSet_);
+    EXPENGINE_VK_ASSERT(setResult, "Failed to allocate the bindless descriptor set");
+}
+
+void TextureTable::createFallbackObjects()
+{
+    vk::DescriptorSetLayoutBinding binding {
+        .binding = 0,
+        .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+        .descriptorCount = 1,
+        .stageFlags = vk::ShaderStageFlagBits::eFragment};
+    auto [layoutResult, layout]
+        = device_.deviceHandle().createDescriptorSetLayoutUnique(
+            {.bindingCount = 1, .pBindings = &binding});
+    EXPENGINE_VK_ASSERT(layoutResult, "Failed to create the texture set layout");
+    descriptorSetLayout_ = std::move(layout);
+}
+
+} // namespace vlk
+} // namespace experim
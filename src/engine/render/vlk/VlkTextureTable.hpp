@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <engine/render/vlk/VlkInclude.hpp>
+
+namespace spdlog {
+class logger;
+}
+
+namespace experim {
+namespace vlk {
+
+class Device;
+
+/**
+ * Textures sampled by the fragment stage, identified by a handle.
+ *
+ * Bindless (device with descriptor indexing) : a single descriptor set holds an
+ * array of BINDLESS_TEXTURE_COUNT combined image samplers (set 0, binding 0). It is
+ * bound once, and the handle is the array index, pushed per draw.
+ *
+ * Fallback : each texture has its own descriptor set with a single combined image
+ * sampler (set 0, binding 0), bound per draw.
+ *
+ * Thread-safe.
+ */
+class TextureTable {
+public:
+    using Handle = uint32_t;
+
+    /** Bindless when allowBindless and the device supports it */
+    TextureTable(const vlk::Device& device, bool allowBindless = true);
+    ~TextureTable();
+
+    TextureTable(const TextureTable&) = delete;
+    TextureTable& operator=(const TextureTable&) = delete;
+
+    inline bool isBindless() const { return bindless_; };
+    inline vk::DescriptorSetLayout layout() const
+    {
+        return descriptorSetLayout_.get();
+    };
+
+    /** imageInfo must hold a sampler */
+    Handle registerTexture(const vk::DescriptorImageInfo& imageInfo);
+    /** The handle may be reused by the next registration : no pending frame may
+     * still sample it, as when destroying the texture itself. */
+    void unregisterTexture(Handle handle);
+
+    /** Set to bind to sample the texture. When bindless, it is the same set for
+     * every texture. */
+    vk::DescriptorSet descriptorSet(Handle handle) const;
+
+private:
+    /* References */
+    const vlk::Device& device_;
+
+    /* Configuration */
+    const bool bindless_;
+
+    /* Owned objects */
+    vk::UniqueDescriptorSetLayout descriptorSetLayout_;
+    /* Bindless only. Sets are owned by their pool. */
+    vk::UniqueDescriptorPool bindlessPool_;
+    vk::DescriptorSet bindlessSet_;
+    /* Fallback only, indexed by handle. From the device allocator. */
+    std::vector<vk::DescriptorSet> textureSets_;
+
+    /* Handles */
+    mutable std::mutex handlesMutex_;
+    Handle nextHandle_;
+    std::vector<Handle> freeHandles_;
+
+    /* Logging */
+    std::shared_ptr<spdlog::logger> logger_;
+
+    void createBindlessObjects();
+    void createFallbackObjects();
+};
+
+} // namespace vlk
+} // namespace experim
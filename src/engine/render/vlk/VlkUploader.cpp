@@ -0,0 +1,363 @@
+#include "VlkUploader.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <engine/log/ExpengineLog.hpp>
+#include <engine/render/vlk/VlkCommandBuffer.hpp>
+#include <engine/render/vlk/VlkDebug.hpp>
+#include <engine/render/vlk/VlkDevice.hpp>
+#include <engine/render/vlk/VlkMemoryAllocator.hpp>
+#include <engine/render/vlk/VlkQueueTimeline.hpp>
+#include <engine/render/vlk/VlkStagingRing.hpp>
+#include <engine/render/vlk/resources/VlkBuffer.hpp>
+#include <engine/render/vlk/resources/VlkImage.hpp>
+
+namespace {
+
+/* Enough for a few hundreds of average textures per frame */
+const vk::DeviceSize STAGING_RING_CAPACITY = 32 * 1024 * 1024;
+/* Multiple of every power-of-two texel size */
+const vk::DeviceSize MIN_STAGING_ALIGNMENT = 16;
+
+} // namespace
+
+namespace experim {
+namespace vlk {
+
+Uploader::Uploader(const vlk::Device& device)
+    : device_(device)
+    , lastId_(0)
+    , pendingCount_(0)
+{
+    auto transferPoolResult = device_.deviceHandle().createCommandPoolUnique(
+        {.flags = vk::CommandPoolCreateFlagBits::eTransient,
+         .queueFamilyIndex = device_.transferFamily()});
+    EXPENGINE_VK_ASSERT(
+        transferPoolResult.result, "Failed to create the upload command pool");
+    transferCommandPool_ = std::move(transferPoolResult.value);
+
+    if (device_.hasDedicatedTransferQueue())
+    {
+        auto acquirePoolResult = device_.deviceHandle().createCommandPoolUnique(
+            {.flags = vk::CommandPoolCreateFlagBits::eTransient,
+             .queueFamilyIndex = device_.queueIndices().graphicsFamily.value()});
+        EXPENGINE_VK_ASSERT(
+            acquirePoolResult.result,
+            "Failed to create the upload acquire command pool");
+        acquireCommandPool_ = std::move(acquirePoolResult.value);
+    }
+
+    stagingRing_
+        = std::make_unique<StagingRing>(device_.allocator(), STAGING_RING_CAPACITY);
+    stagingAlignment_ = std::max(
+        MIN_STAGING_ALIGNMENT,
+        device_.properties().limits.optimalBufferCopyOffsetAlignment);
+}
+
+Uploader::~Uploader()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    submitOpenBatch();
+    if (!pending_.empty())
+        device_.graphicsTimeline().wait(pending_.back().submittedValue);
+    pending_.clear();
+}
+
+UploadToken Uploader::uploadImage(
+    VlkImage& image,
+    const void* data,
+    vk::DeviceSize size,
+    const vk::BufferImageCopy& copyRegion,
+    vk::ImageLayout finalLayout,
+    vk::PipelineStageFlags dstStages,
+    vk::AccessFlags dstAccess)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    collectCompletedLocked();
+
+    /* Staged first : may submit the open batch to make room */
+    auto staged = stage(data, size);
+    auto& batch = currentBatch();
+    auto& transferCmd = *batch.transferCommands;
+
+    vk::ImageSubresourceRange range {
+        .aspectMask = copyRegion.imageSubresource.aspectMask,
+        .baseMipLevel = copyRegion.imageSubresource.mipLevel,
+        .levelCount = 1,
+        .baseArrayLayer = copyRegion.imageSubresource.baseArrayLayer,
+        .layerCount = copyRegion.imageSubresource.layerCount};
+
+    image.transitionImageLayout(
+        transferCmd.getHandle(),
+        vk::ImageLayout::eUndefined,
+        vk::ImageLayout::eTransferDstOptimal,
+        range,
+        vk::PipelineStageFlagBits::eTopOfPipe,
+        vk::PipelineStageFlagBits::eTransfer);
+    auto stagedRegion = copyRegion;
+    stagedRegion.bufferOffset = staged.offset;
+    transferCmd.copyBufferToImage(staged.buffer, image.getHandle(), stagedRegion);
+
+    if (!device_.hasDedicatedTransferQueue())
+    {
+        image.transitionImageLayout(
+            transferCmd.getHandle(),
+            vk::ImageLayout::eTransferDstOptimal,
+            finalLayout,
+            range,
+            vk::PipelineStageFlagBits::eTransfer,
+            dstStages);
+        return {.id = batch.id};
+    }
+
+    /* Ownership transfer : the layout transition is shared by the release and the
+     * acquire barriers, which must match. The release ignores the destination
+     * access, the acquire the source access (made available by the semaphore). */
+    vk::ImageMemoryBarrier ownershipBarrier {
+        .oldLayout = vk::ImageLayout::eTransferDstOptimal,
+        .newLayout = finalLayout,
+        .srcQueueFamilyIndex = device_.transferFamily(),
+        .dstQueueFamilyIndex = device_.queueIndices().graphicsFamily.value(),
+        .image = image.getHandle(),
+        .subresourceRange = range};
+
+    auto releaseBarrier = ownershipBarrier;
+    releaseBarrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    transferCmd.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eBottomOfPipe,
+        releaseBarrier);
+
+    auto acquireBarrier = ownershipBarrier;
+    acquireBarrier.dstAccessMask = dstAccess;
+    batch.acquireCommands->pipelineBarrier(dstStages, dstStages, acquireBarrier);
+    batch.acquireStages |= dstStages;
+    image.setLayout(finalLayout);
+
+    return {.id = batch.id};
+}
+
+UploadToken Uploader::uploadBuffer(
+    const Buffer& buffer,
+    const void* data,
+    vk::DeviceSize size,
+    vk::DeviceSize dstOffset,
+    vk::PipelineStageFlags dstStages,
+    vk::AccessFlags dstAccess)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    collectCompletedLocked();
+
+    auto staged = stage(data, size);
+    auto& batch = currentBatch();
+    auto& transferCmd = *batch.transferCommands;
+
+    transferCmd.copyBuffer(
+        staged.buffer,
+        buffer.getHandle(),
+        {.srcOffset = staged.offset, .dstOffset = dstOffset, .size = size});
+
+    vk::BufferMemoryBarrier barrier {
+        .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+        .dstAccessMask = dstAccess,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = buffer.getHandle(),
+        .offset = dstOffset,
+        .size = size};
+
+    if (!device_.hasDedicatedTransferQueue())
+    {
+        transferCmd.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer, dstStages, barrier);
+        return {.id = batch.id};
+    }
+
+    barrier.srcQueueFamilyIndex = device_.transferFamily();
+    barrier.dstQueueFamilyIndex = device_.queueIndices().graphicsFamily.value();
+
+    auto releaseBarrier = barrier;
+    releaseBarrier.dstAccessMask = {};
+    transferCmd.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eBottomOfPipe,
+        releaseBarrier);
+
+    auto acquireBarrier = barrier;
+    acquireBarrier.srcAccessMask = {};
+    batch.acquireCommands->pipelineBarrier(dstStages, dstStages, acquireBarrier);
+    batch.acquireStages |= dstStages;
+
+    return {.id = batch.id};
+}
+
+void Uploader::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    submitOpenBatch();
+}
+
+bool Uploader::isComplete(UploadToken token)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (openBatch_ && openBatch_->id == token.id)
+        return false;
+
+    for (const auto& batch : pending_)
+    {
+        if (batch.id == token.id)
+        {
+            return device_.graphicsTimeline().isReached(batch.submittedValue);
+        }
+    }
+    /* Unknown, already collected */
+    return true;
+}
+
+void Uploader::wait(UploadToken token)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (openBatch_ && openBatch_->id == token.id)
+        submitOpenBatch();
+
+    for (const auto& batch : pending_)
+    {
+        if (batch.id == token.id)
+        {
+            device_.graphicsTimeline().wait(batch.submittedValue);
+            break;
+        }
+    }
+    collectCompletedLocked();
+}
+
+void Uploader::collectCompleted()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    collectCompletedLocked();
+}
+
+Uploader::StagedData Uploader::stage(const void* data, vk::DeviceSize size)
+{
+    if (size > stagingRing_->capacity())
+    {
+        auto stagingBuffer = device_.allocator().createStagingBuffer(size, data);
+        StagedData staged {.buffer = stagingBuffer->getHandle(), .offset = 0};
+        currentBatch().dedicatedStagingBuffers.push_back(std::move(stagingBuffer));
+        return staged;
+    }
+
+    auto region = stagingRing_->allocate(size, stagingAlignment_);
+    while (!region)
+    {
+        /* Ring full : wait for the oldest batch. The open batch owns the most
+         * recent regions, it is submitted when nothing else is in flight. */
+        if (pending_.empty())
+            submitOpenBatch();
+        EXPENGINE_ASSERT(!pending_.empty(), "Staging ring full without any upload");
+
+        device_.graphicsTimeline().wait(pending_.front().submittedValue);
+        collectCompletedLocked();
+
+        region = stagingRing_->allocate(size, stagingAlignment_);
+    }
+
+    std::memcpy(region->data, data, size);
+    return {.buffer = region->buffer, .offset = region->offset};
+}
+
+Uploader::UploadBatch& Uploader::currentBatch()
+{
+    if (openBatch_)
+        return *openBatch_;
+
+    openBatch_ = std::make_unique<UploadBatch>();
+    openBatch_->id = ++lastId_;
+
+    openBatch_->transferCommands
+        = std::make_unique<CommandBuffer>(device_, transferCommandPool_.get());
+    openBatch_->transferCommands->begin(
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+
+    if (device_.hasDedicatedTransferQueue())
+    {
+        openBatch_->acquireCommands
+            = std::make_unique<CommandBuffer>(device_, acquireCommandPool_.get());
+        openBatch_->acquireCommands->begin(
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+
+        auto semaphoreResult = device_.deviceHandle().createSemaphoreUnique({});
+        EXPENGINE_VK_ASSERT(
+            semaphoreResult.result, "Failed to create an upload semaphore");
+        openBatch_->ownershipSemaphore = std::move(semaphoreResult.value);
+    }
+
+    return *openBatch_;
+}
+
+void Uploader::submitOpenBatch()
+{
+    if (!openBatch_)
+        return;
+    auto& batch = *openBatch_;
+
+    batch.transferCommands->end();
+    auto transferHandle = batch.transferCommands->getHandle();
+
+    {
+        std::lock_guard<std::mutex> queueLock(device_.queueMutex());
+        if (!device_.hasDedicatedTransferQueue())
+        {
+            vk::SubmitInfo submitInfo {
+                .commandBufferCount = 1, .pCommandBuffers = &transferHandle};
+            batch.submittedValue = device_.graphicsTimeline().submit(submitInfo);
+        }
+        else
+        {
+            batch.acquireCommands->end();
+            auto acquireHandle = batch.acquireCommands->getHandle();
+            auto semaphore = batch.ownershipSemaphore.get();
+
+            vk::SubmitInfo transferSubmitInfo {
+                .commandBufferCount = 1,
+                .pCommandBuffers = &transferHandle,
+                .signalSemaphoreCount = 1,
+                .pSignalSemaphores = &semaphore};
+            auto res = device_.transferQueue().submit(transferSubmitInfo, nullptr);
+            EXPENGINE_VK_ASSERT(
+                res, "Failed to submit an upload to the transfer queue");
+
+            /* The graphics queue only waits for the transfer at the stages using
+             * the resources */
+            vk::SubmitInfo acquireSubmitInfo {
+                .waitSemaphoreCount = 1,
+                .pWaitSemaphores = &semaphore,
+                .pWaitDstStageMask = &batch.acquireStages,
+                .commandBufferCount = 1,
+                .pCommandBuffers = &acquireHandle};
+            batch.submittedValue
+                = device_.graphicsTimeline().submit(acquireSubmitInfo);
+        }
+    }
+
+    stagingRing_->closeBatch(batch.id);
+    pending_.push_back(std::move(batch));
+    openBatch_.reset();
+    pendingCount_.store(pending_.size());
+}
+
+void Uploader::collectCompletedLocked()
+{
+    /* Staging regions are released in submission order */
+    while (!pending_.empty()
+           && device_.graphicsTimeline().isReached(pending_.front().submittedValue))
+    {
+        stagingRing_->releaseBatches(pending_.front().id);
+        pending_.pop_front();
+    }
+    pendingCount_.store(pending_.size());
+}
+
+} // namespace vlk
+} // namespace experim
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <engine/render/vlk/VlkInclude.hpp>
+
+namespace experim {
+namespace vlk {
+
+class Buffer;
+class CommandBuffer;
+class Device;
+class StagingRing;
+class VlkImage;
+
+/** Identifies an upload. The default token refers to no upload and is always
+ * complete. */
+struct UploadToken {
+    uint64_t id = 0;
+};
+
+/**
+ * Copies host data to device local resources, without waiting for the copies.
+ * The data is written into a persistently mapped staging ring, and the uploads are
+ * batched into a single command buffer until flush(). Rendering contexts flush
+ * before submitting a frame : graphics submissions are ordered after the uploads
+ * issued before them, so the destination can be used right away without any CPU
+ * wait.
+ *
+ * Uses the dedicated transfer queue of the device when there is one : the
+ * resources are then released by the transfer family and acquired by the graphics
+ * family.
+ *
+ * The token is only needed to know when the copy is executed, before reading the
+ * resource from the host or destroying it.
+ *
+ * Thread-safe : uploads may be issued from any thread.
+ */
+class Uploader {
+public:
+    Uploader(const vlk::Device& device);
+    ~Uploader();
+
+    /**
+     * @brief Copies size bytes of data into a region of image, which is left in
+     * finalLayout. The previous content of the image is discarded. The
+     * bufferOffset of copyRegion is ignored.
+     *
+     * @param dstStages Stages of the graphics queue that will first use the image
+     */
+    UploadToken uploadImage(
+        VlkImage& image,
+        const void* data,
+        vk::DeviceSize size,
+        const vk::BufferImageCopy& copyRegion,
+        vk::ImageLayout finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+        vk::PipelineStageFlags dstStages
+        = vk::PipelineStageFlagBits::eFragmentShader,
+        vk::AccessFlags dstAccess = vk::AccessFlagBits::eShaderRead);
+
+    /**
+     * @brief Copies size bytes of data into buffer, at dstOffset.
+     *
+     * @param dstStages Stages of the graphics queue that will first use the buffer
+     */
+    UploadToken uploadBuffer(
+        const Buffer& buffer,
+        const void* data,
+        vk::DeviceSize size,
+        vk::DeviceSize dstOffset = 0,
+        vk::PipelineStageFlags dstStages = vk::PipelineStageFlagBits::eVertexInput,
+        vk::AccessFlags dstAccess
+        = vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead);
+
+    /** Submits the batched uploads */
+    void flush();
+
+    /** Non-blocking */
+    bool isComplete(UploadToken token);
+    /** Blocks until the upload is executed by the GPU. Flushes it if needed. */
+    void wait(UploadToken token);
+    /** Releases the staging memory and command buffers of the executed uploads.
+     * Called on each upload, and by the renderer once per frame. */
+    void collectCompleted();
+
+    /** Submitted batches not yet collected */
+    inline size_t pendingCount() const { return pendingCount_.load(); };
+
+private:
+    struct UploadBatch {
+        uint64_t id;
+        /* Graphics timeline value reached once the batch is executed */
+        uint64_t submittedValue;
+        /* Transfer family to graphics family, only with a dedicated transfer
+         * queue */
+        vk::UniqueSemaphore ownershipSemaphore;
+        std::unique_ptr<CommandBuffer> transferCommands;
+        std::unique_ptr<CommandBuffer> acquireCommands;
+        vk::PipelineStageFlags acquireStages;
+        /* Uploads too large for the staging ring */
+        std::vector<std::unique_ptr<Buffer>> dedicatedStagingBuffers;
+    };
+
+    struct StagedData {
+        vk::Buffer buffer;
+        vk::DeviceSize offset;
+    };
+
+    /* References */
+    const vlk::Device& device_;
+
+    /* Owned objects */
+    vk::UniqueCommandPool transferCommandPool_;
+    /* Graphics family pool for the acquire barriers */
+    vk::UniqueCommandPool acquireCommandPool_;
+    std::unique_ptr<StagingRing> stagingRing_;
+    vk::DeviceSize stagingAlignment_;
+
+    /* Batches */
+    std::mutex mutex_;
+    std::unique_ptr<UploadBatch> openBatch_;
+    /* Submission order */
+    std::deque<UploadBatch> pending_;
+    uint64_t lastId_;
+    /* Readable without the lock, for statistics */
+    std::atomic<size_t> pendingCount_;
+
+    /* Must be called with the lock held */
+    StagedData stage(const void* data, vk::DeviceSize size);
+    UploadBatch& currentBatch();
+    void submitOpenBatch();
+    void collectCompletedLocked();
+};
+
+} // namespace vlk
+} // namespace experim
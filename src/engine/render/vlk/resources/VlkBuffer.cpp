@@ -40,6 +40,8 @@ Buffer::Buffer(
 
 Buffer::~Buffer()
 {
+    /* Persistently mapped buffers are unmapped on destruction */
+    unmap();
     /*  Buffer is released but we need to handle the VMA allocated memory manually */
     vmaFreeMemory(allocator_, allocation_);
 }
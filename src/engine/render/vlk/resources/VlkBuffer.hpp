@@ -41,6 +41,9 @@ public:
     /* Accessors */
     inline vk::Buffer getHandle() const { return buffer_.get(); };
     inline size_t size() const { return size_; };
+    /** Null when the buffer is not mapped */
+    inline const void* mappedData() const { return mapped_; };
+    inline void* mappedData() { return mapped_; };
 
 private:
     /* Handles */
@@ -27,6 +27,9 @@ public:
     inline const vk::Image getHandle() { return image_.get(); };
     inline const vk::Extent3D getExtent() { return imgInfo_.extent; };
     inline const vk::ImageLayout getLayout() { return layout_; }
+    /** For layout transitions recorded outside of transitionImageLayout (queue
+     * ownership transfers) */
+    inline void setLayout(vk::ImageLayout layout) { layout_ = layout; }
 
     /**
      * @brief Put an image memory barrier for setting an image layout on the
@@ -3,6 +3,7 @@
 #include <engine/render/vlk/VlkDebug.hpp>
 #include <engine/render/vlk/VlkDevice.hpp>
 #include <engine/render/vlk/VlkMemoryAllocator.hpp>
+#include <engine/render/vlk/VlkUploader.hpp>
 #include <engine/render/vlk/resources/VlkImage.hpp>
 
 namespace experim {
@@ -18,12 +19,9 @@ VlkTexture::VlkTexture(
     const vk::Sampler sampler,
     vk::ImageUsageFlags imageUsageFlags,
     vk::ImageLayout targetImgLayout)
-    : sampler_(sampler)
+    : device_(device)
+    , sampler_(sampler)
 {
-    /* Upload texData to accessible device memory */
-    auto stagingBuffer
-        = device.allocator().createStagingBuffer(texDataSize, texData);
-
     /* Create image (as a transfer dest) */
     image_ = device.allocator().createTextureImage(
         imageUsageFlags | vk::ImageUsageFlagBits::eTransferDst,
@@ -31,16 +29,9 @@ VlkTexture::VlkTexture(
         texWidth,
         texHeight);
 
-    auto imageCopyCmdBuffer = device.createTransientCommandBuffer();
-
-    /* Transition image layout to VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL */
-    image_->transitionImageLayout(
-        imageCopyCmdBuffer.getHandle(),
-        vk::ImageLayout::eUndefined,
-        vk::ImageLayout::eTransferDstOptimal,
-        vk::ImageAspectFlagBits::eColor);
-
-    /* Copy stagingBuffer to image */
+    /* Copy texData to image through the staging ring, then transition its layout
+     * (default to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL). Asynchronous, texData
+     * can be released on return. */
     vk::BufferImageCopy bufferCopyRegion {
         .imageSubresource
         = {.aspectMask = vk::ImageAspectFlagBits::eColor,
@@ -48,18 +39,8 @@ VlkTexture::VlkTexture(
            .baseArrayLayer = 0,
            .layerCount = 1},
         .imageExtent = image_->getExtent()};
-    imageCopyCmdBuffer.copyBufferToImage(
-        stagingBuffer->getHandle(), image_->getHandle(), bufferCopyRegion);
-
-    /* Transition layout (defautl to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) */
-    image_->transitionImageLayout(
-        imageCopyCmdBuffer.getHandle(),
-        vk::ImageLayout::eTransferDstOptimal,
-        targetImgLayout,
-        vk::ImageAspectFlagBits::eColor);
-
-    /* TODO Implement fence signaling in buffer sumbission */
-    device.submitTransientCommandBuffer(imageCopyCmdBuffer);
+    uploadToken_ = device.uploader().uploadImage(
+        *image_, texData, texDataSize, bufferCopyRegion, targetImgLayout);
 
     /* Create Image View */
     auto createViewResult = device.deviceHandle().createImageViewUnique(
@@ -81,5 +62,11 @@ VlkTexture::VlkTexture(
     descriptorInfo_.imageLayout = image_->getLayout();
 }
 
+VlkTexture::~VlkTexture()
+{
+    /* The image must outlive its copy */
+    device_.uploader().wait(uploadToken_);
+}
+
 } // namespace vlk
 } // namespace experim
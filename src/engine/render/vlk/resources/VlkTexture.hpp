@@ -2,6 +2,7 @@
 
 #include <engine/render/vlk/VlkDevice.hpp>
 #include <engine/render/vlk/VlkInclude.hpp>
+#include <engine/render/vlk/VlkUploader.hpp>
 #include <engine/render/vlk/resources/VlkImage.hpp>
 
 namespace experim {
@@ -23,14 +24,21 @@ public:
         const vk::Sampler sampler,
         vk::ImageUsageFlags imageUsageFlags = vk::ImageUsageFlagBits::eSampled,
         vk::ImageLayout targetImgLayout = vk::ImageLayout::eShaderReadOnlyOptimal);
+    ~VlkTexture();
 
     inline vk::Image imageHandle() const { return image_->getHandle(); };
     inline const vk::DescriptorImageInfo& descriptorInfo() const
     {
         return descriptorInfo_;
     }
+    /** The texture can be sampled by graphics submissions right away, the token
+     * only tells when the GPU copy is done. */
+    inline UploadToken uploadToken() const { return uploadToken_; }
 
 private:
+    /* References */
+    const vlk::Device& device_;
+
     /* Handles */
     /* A sampler may be shared with multiples textures */
     /* TODO may create default sampler is none is provided ? */
@@ -42,6 +50,7 @@ private:
 
     /* Info */
     vk::DescriptorImageInfo descriptorInfo_;
+    UploadToken uploadToken_;
 };
 } // namespace vlk
 } // namespace experim
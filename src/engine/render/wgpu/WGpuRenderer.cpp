@@ -8,6 +8,7 @@
 #endif
 
 #include <ExperimEngineConfig.h>
+#include <engine/EngineParameters.hpp>
 #include <engine/log/ExpengineLog.hpp>
 #include <engine/render/imgui/ImGuiBackend.hpp>
 #include <engine/render/resources/Texture.hpp>
@@ -93,6 +94,34 @@ void WebGpuRenderer::renderFrame()
     mainRenderingContext_->submitFrame();
 }
 
+void WebGpuRenderer::setRenderThreadEnabled(bool enabled)
+{
+    if (enabled)
+    {
+        SPDLOG_LOGGER_WARN(
+            logger_, "WebGPU renderer : render thread not supported, ignored");
+    }
+}
+
+void WebGpuRenderer::setFrameReadback(const std::string&, uint32_t)
+{
+    SPDLOG_LOGGER_WARN(
+        logger_, "WebGPU renderer : frame readback not supported, ignored");
+}
+
+void WebGpuRenderer::setFramesInFlight(uint32_t)
+{
+    SPDLOG_LOGGER_WARN(
+        logger_, "WebGPU renderer : frames in flight not configurable, ignored");
+}
+
+void WebGpuRenderer::setGraphicSettings(const GraphicSettings& graphicSettings)
+{
+    engineParams_.graphicSettings = graphicSettings;
+    SPDLOG_LOGGER_WARN(
+        logger_, "WebGPU renderer : graphic settings not supported, ignored");
+}
+
 void WebGpuRenderer::waitIdle()
 {
     SPDLOG_LOGGER_DEBUG(logger_, "WebGPU waitIdle implementation : nothing to do");
@@ -32,6 +32,11 @@ public:
     bool handleEvent(const SDL_Event& event) override;
     void prepareFrame() override;
     void renderFrame() override;
+    void setRenderThreadEnabled(bool enabled) override;
+    void setFrameReadback(const std::string& directory, uint32_t frameInterval)
+        override;
+    void setFramesInFlight(uint32_t framesInFlight) override;
+    void setGraphicSettings(const GraphicSettings& graphicSettings) override;
 
     void waitIdle() override;
     std::shared_ptr<Window> getMainWindow() const override;
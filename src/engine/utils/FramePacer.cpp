@@ -0,0 +1,110 @@
+#include "FramePacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+using SleepDuration = std::chrono::duration<double, experim::Milliseconds>;
+
+/* Sleep granularity. Short enough to stop sleeping close to the deadline. */
+const SleepDuration SLEEP_STEP(1.0);
+/* Pessimistic until measured : sleeps can last a whole scheduler quantum */
+const double INITIAL_OVERSHOOT_ESTIMATE_MS = 5.0;
+/* Caps the sample count so that the estimate keeps adapting to the system load */
+const uint64_t MAX_OVERSHOOT_SAMPLES = 1000;
+/* Weight of the last frame in the average jitter */
+const double JITTER_SMOOTHING = 0.05;
+
+} // namespace
+
+namespace experim {
+
+FramePacer::FramePacer()
+    : period_(Clock::duration::zero())
+    , deadline_(Clock::now())
+    , overshootMean_(INITIAL_OVERSHOOT_ESTIMATE_MS)
+    , overshootM2_(0.0)
+    , overshootSamples_(1)
+{
+}
+
+void FramePacer::setTargetRate(float framesPerSecond)
+{
+    if (framesPerSecond <= 0)
+        period_ = Clock::duration::zero();
+    else
+        period_ = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / framesPerSecond));
+
+    deadline_ = Clock::now() + period_;
+}
+
+void FramePacer::wait()
+{
+    if (period_ == Clock::duration::zero())
+        return;
+
+    auto now = Clock::now();
+    if (now >= deadline_)
+    {
+        stats_.missedDeadlines++;
+        /* Late by more than a period : resynchronize instead of rushing the next
+         * frames to catch up */
+        if (now - deadline_ > period_)
+            deadline_ = now;
+    }
+    else
+    {
+        sleepUntilSpinThreshold();
+
+        /* Spin for the remaining time */
+        while ((now = Clock::now()) < deadline_)
+        {
+            std::this_thread::yield();
+        }
+
+        double jitter = SleepDuration(now - deadline_).count();
+        stats_.lastJitter = jitter;
+        stats_.averageJitter
+            += JITTER_SMOOTHING * (jitter - stats_.averageJitter);
+        stats_.maxJitter = std::max(stats_.maxJitter, jitter);
+    }
+
+    /* Absolute deadlines : the next one does not depend on when we woke up */
+    deadline_ += period_;
+}
+
+void FramePacer::resetPeakStatistics() { stats_.maxJitter = 0.0; }
+
+void FramePacer::sleepUntilSpinThreshold()
+{
+    while (true)
+    {
+        double overshootStdDev
+            = std::sqrt(overshootM2_ / std::max<uint64_t>(1, overshootSamples_ - 1));
+        double threshold = SLEEP_STEP.count() + overshootMean_ + overshootStdDev;
+        auto start = Clock::now();
+        if (SleepDuration(deadline_ - start).count() <= threshold)
+            break;
+
+        std::this_thread::sleep_for(SLEEP_STEP);
+        double slept = SleepDuration(Clock::now() - start).count();
+        updateOvershootEstimate(slept - SLEEP_STEP.count());
+    }
+}
+
+void FramePacer::updateOvershootEstimate(double overshoot)
+{
+    if (overshootSamples_ < MAX_OVERSHOOT_SAMPLES)
+        overshootSamples_++;
+    double delta = overshoot - overshootMean_;
+    overshootMean_ += delta / overshootSamples_;
+    overshootM2_ += delta * (overshoot - overshootMean_);
+    /* Keep the variance consistent with the capped sample count */
+    if (overshootSamples_ == MAX_OVERSHOOT_SAMPLES)
+        overshootM2_ *= (double) (MAX_OVERSHOOT_SAMPLES - 1) / MAX_OVERSHOOT_SAMPLES;
+}
+
+} // namespace experim
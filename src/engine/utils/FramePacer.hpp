@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+#include <engine/utils/Timer.hpp>
+
+namespace experim {
+
+struct FramePacingStatistics {
+    /** @brief Lateness (in ms) of the last wake-up relative to its deadline. */
+    double lastJitter = 0.0;
+    /** @brief Moving average of the wake-up lateness (in ms). */
+    double averageJitter = 0.0;
+    /** @brief Highest wake-up lateness (in ms) since the last peak reset. */
+    double maxJitter = 0.0;
+    /** @brief Number of frames that ended after their deadline. */
+    uint64_t missedDeadlines = 0;
+};
+
+/** Limits the frame rate. Deadlines are absolute, so that waiting errors do not
+ * accumulate from one frame to the next. The wait sleeps while the remaining time is
+ * comfortably longer than the observed sleep overshoot, then spins until the
+ * deadline. */
+class FramePacer {
+public:
+    FramePacer();
+
+    /** A rate of 0 disables pacing. */
+    void setTargetRate(float framesPerSecond);
+    /** Blocks until the end of the current frame period. */
+    void wait();
+
+    inline const FramePacingStatistics& statistics() const { return stats_; };
+    void resetPeakStatistics();
+
+private:
+    using Clock = Timer::Clock;
+
+    /* Configuration */
+    Clock::duration period_;
+    Clock::time_point deadline_;
+
+    /* Online estimate (Welford) of how much longer than requested a sleep lasts */
+    double overshootMean_;
+    double overshootM2_;
+    uint64_t overshootSamples_;
+
+    /* Statistics */
+    FramePacingStatistics stats_;
+
+    void sleepUntilSpinThreshold();
+    void updateOvershootEstimate(double overshoot);
+};
+
+} // namespace experim
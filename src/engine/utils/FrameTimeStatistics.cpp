@@ -0,0 +1,222 @@
+#include "FrameTimeStatistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace {
+
+const double MICROSEC_PER_MILLISEC = 1000.0;
+/* The median is not meaningful on the very first frames */
+const uint32_t MIN_SAMPLES_FOR_STUTTER = 30;
+
+const char* METRIC_NAMES[]
+    = {"frame", "simulation", "recording", "present-wait", "pacing"};
+
+uint32_t mostSignificantBit(uint64_t value)
+{
+    uint32_t msb = 0;
+    while (value >>= 1)
+    {
+        msb++;
+    }
+    return msb;
+}
+
+} // namespace
+
+namespace experim {
+
+/* ------------------------------------------- */
+/* DurationHistogram                           */
+/* ------------------------------------------- */
+
+DurationHistogram::DurationHistogram() { clear(); }
+
+void DurationHistogram::add(double milliseconds)
+{
+    buckets_[bucketIndex(milliseconds)]++;
+    count_++;
+}
+
+void DurationHistogram::remove(double milliseconds)
+{
+    auto& bucket = buckets_[bucketIndex(milliseconds)];
+    if (bucket > 0)
+    {
+        bucket--;
+        count_--;
+    }
+}
+
+void DurationHistogram::clear()
+{
+    buckets_.fill(0);
+    count_ = 0;
+}
+
+double DurationHistogram::percentile(double percent) const
+{
+    if (count_ == 0)
+        return 0.0;
+
+    const auto rank = std::max<uint64_t>(
+        1, static_cast<uint64_t>(std::ceil(percent / 100.0 * count_)));
+    uint64_t cumulated = 0;
+    for (uint32_t index = 0; index < BUCKET_COUNT; index++)
+    {
+        cumulated += buckets_[index];
+        if (cumulated >= rank)
+            return bucketValue(index);
+    }
+    return bucketValue(BUCKET_COUNT - 1);
+}
+
+uint32_t DurationHistogram::bucketIndex(double milliseconds)
+{
+    const uint64_t maxValue = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+    const auto value = std::min(
+        maxValue,
+        static_cast<uint64_t>(std::max(0.0, milliseconds * MICROSEC_PER_MILLISEC)));
+    if (value < SUB_BUCKET_COUNT)
+        return static_cast<uint32_t>(value);
+
+    /* Octave 1 holds [32, 64) with a step of 1, octave 2 [64, 128) with a step of
+     * 2, ... */
+    const uint32_t msb = mostSignificantBit(value);
+    const uint32_t octave = msb - SUB_BUCKET_BITS + 1;
+    const auto subBucket
+        = static_cast<uint32_t>(value >> (msb - SUB_BUCKET_BITS)) - SUB_BUCKET_COUNT;
+    return octave * SUB_BUCKET_COUNT + subBucket;
+}
+
+double DurationHistogram::bucketValue(uint32_t index)
+{
+    if (index < SUB_BUCKET_COUNT)
+        return index / MICROSEC_PER_MILLISEC;
+
+    const uint32_t octave = index / SUB_BUCKET_COUNT;
+    const uint32_t subBucket = index % SUB_BUCKET_COUNT;
+    const uint64_t width = uint64_t(1) << (octave - 1);
+    const uint64_t lowerBound = (SUB_BUCKET_COUNT + subBucket) * width;
+    return (lowerBound + (width - 1) / 2.0) / MICROSEC_PER_MILLISEC;
+}
+
+/* ------------------------------------------- */
+/* FrameTimeStatistics                         */
+/* ------------------------------------------- */
+
+FrameTimeStatistics::FrameTimeStatistics(uint32_t windowSize)
+    : samples_(std::max(1u, windowSize))
+    , nextSample_(0)
+    , sampleCount_(0)
+    , stutterCount_(0)
+{
+}
+
+void FrameTimeStatistics::addFrame(const FrameTimeSample& sample)
+{
+    auto& frameHistogram = histograms_[size_t(FrameMetric::eFrame)];
+    if (frameHistogram.count() >= MIN_SAMPLES_FOR_STUTTER
+        && sample[FrameMetric::eFrame]
+            > STUTTER_FACTOR * frameHistogram.percentile(50.0))
+    {
+        stutterCount_++;
+    }
+
+    /* Evict the oldest sample of the window */
+    auto& slot = samples_[nextSample_];
+    if (sampleCount_ == samples_.size())
+    {
+        for (size_t metric = 0; metric < histograms_.size(); metric++)
+        {
+            histograms_[metric].remove(slot.durations[metric]);
+        }
+    }
+    else
+    {
+        sampleCount_++;
+    }
+
+    slot = sample;
+    for (size_t metric = 0; metric < histograms_.size(); metric++)
+    {
+        histograms_[metric].add(sample.durations[metric]);
+    }
+    nextSample_ = (nextSample_ + 1) % static_cast<uint32_t>(samples_.size());
+}
+
+void FrameTimeStatistics::reset()
+{
+    nextSample_ = 0;
+    sampleCount_ = 0;
+    stutterCount_ = 0;
+    for (auto& histogram : histograms_)
+    {
+        histogram.clear();
+    }
+}
+
+FrameTimeSummary FrameTimeStatistics::summary(FrameMetric metric) const
+{
+    const auto& histogram = histograms_[size_t(metric)];
+    FrameTimeSummary summary {
+        .p50 = histogram.percentile(50.0),
+        .p95 = histogram.percentile(95.0),
+        .p99 = histogram.percentile(99.0)};
+
+    /* Exact maximum, the window is small enough to be scanned */
+    for (uint32_t i = 0; i < sampleCount_; i++)
+    {
+        summary.max = std::max(summary.max, samples_[i][metric]);
+    }
+    return summary;
+}
+
+bool FrameTimeStatistics::exportSamplesCsv(const std::string& filePath) const
+{
+    std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    file << "index";
+    for (auto name : METRIC_NAMES)
+    {
+        file << "," << name << "_ms";
+    }
+    file << "\n";
+
+    /* Oldest sample first : the ring only wrapped once the window is full */
+    const uint32_t windowSize = static_cast<uint32_t>(samples_.size());
+    const uint32_t first = sampleCount_ == windowSize ? nextSample_ : 0;
+    for (uint32_t i = 0; i < sampleCount_; i++)
+    {
+        const auto& sample = samples_[(first + i) % windowSize];
+        file << i;
+        for (auto duration : sample.durations)
+        {
+            file << "," << duration;
+        }
+        file << "\n";
+    }
+    return file.good();
+}
+
+bool FrameTimeStatistics::exportSummaryCsv(const std::string& filePath) const
+{
+    std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    file << "metric,samples,p50_ms,p95_ms,p99_ms,max_ms,stutters\n";
+    for (uint32_t metric = 0; metric < uint32_t(FrameMetric::eCount); metric++)
+    {
+        auto stats = summary(FrameMetric(metric));
+        file << METRIC_NAMES[metric] << "," << sampleCount_ << "," << stats.p50
+             << "," << stats.p95 << "," << stats.p99 << "," << stats.max << ","
+             << stutterCount_ << "\n";
+    }
+    return file.good();
+}
+
+} // namespace experim
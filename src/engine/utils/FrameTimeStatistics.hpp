@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace experim {
+
+/** Histogram of durations with a bounded relative error (HDR-style) : exact buckets
+ * up to 32 us, then 32 buckets per power of two (about 3% of error). Values are
+ * clamped to about 16 s. Fixed memory. */
+class DurationHistogram {
+public:
+    DurationHistogram();
+
+    void add(double milliseconds);
+    void remove(double milliseconds);
+    void clear();
+
+    inline uint64_t count() const { return count_; };
+    /** Returns the duration (in ms) under which percent % of the values are. 0 if
+     * empty. */
+    double percentile(double percent) const;
+
+private:
+    static const uint32_t SUB_BUCKET_BITS = 5;
+    static const uint32_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static const uint32_t MAX_VALUE_BITS = 24;
+    static const uint32_t BUCKET_COUNT
+        = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    std::array<uint32_t, BUCKET_COUNT> buckets_;
+    uint64_t count_;
+
+    static uint32_t bucketIndex(double milliseconds);
+    /** Middle of the bucket, in ms */
+    static double bucketValue(uint32_t index);
+};
+
+enum class FrameMetric : uint32_t
+{
+    /* Time between the end of two frames */
+    eFrame = 0,
+    /* Events, simulation ticks and frame handlers */
+    eSimulation,
+    /* Recording and submission of the frame by the renderer, waits excluded */
+    eRecording,
+    /* Time spent waiting for a frame in flight and for a swapchain image */
+    ePresentWait,
+    /* Time spent sleeping in the frame pacer */
+    ePacing,
+    eCount
+};
+
+/** Durations (in ms) of one frame, for each FrameMetric */
+struct FrameTimeSample {
+    std::array<double, static_cast<size_t>(FrameMetric::eCount)> durations {};
+
+    inline double& operator[](FrameMetric metric)
+    {
+        return durations[static_cast<size_t>(metric)];
+    };
+    inline double operator[](FrameMetric metric) const
+    {
+        return durations[static_cast<size_t>(metric)];
+    };
+};
+
+struct FrameTimeSummary {
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+/** Keeps the frame time samples of a rolling window of frames, with a histogram
+ * per metric to query percentiles. Fixed memory. */
+class FrameTimeStatistics {
+public:
+    /** A frame is counted as a stutter when it lasts more than STUTTER_FACTOR times
+     * the median frame time. */
+    static constexpr double STUTTER_FACTOR = 2.0;
+
+    FrameTimeStatistics(uint32_t windowSize = 1024);
+
+    void addFrame(const FrameTimeSample& sample);
+    void reset();
+
+    /** Number of frames in the window */
+    inline uint32_t sampleCount() const { return sampleCount_; };
+    /** Stutters since the creation or the last reset */
+    inline uint64_t stutterCount() const { return stutterCount_; };
+    FrameTimeSummary summary(FrameMetric metric) const;
+
+    /** One line per frame of the window, oldest first. Returns false if the file
+     * can't be written. */
+    bool exportSamplesCsv(const std::string& filePath) const;
+    /** One line per metric with its percentiles. */
+    bool exportSummaryCsv(const std::string& filePath) const;
+
+private:
+    std::vector<FrameTimeSample> samples_;
+    /* Next slot of the ring */
+    uint32_t nextSample_;
+    uint32_t sampleCount_;
+    std::array<DurationHistogram, static_cast<size_t>(FrameMetric::eCount)>
+        histograms_;
+    uint64_t stutterCount_;
+};
+
+} // namespace experim
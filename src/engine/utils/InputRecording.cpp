@@ -0,0 +1,171 @@
+#include "InputRecording.hpp"
+
+#include <array>
+#include <cmath>
+
+#include <engine/log/ExpengineLog.hpp>
+
+namespace {
+
+const std::array<char, 4> RECORDING_MAGIC = {'E', 'X', 'I', 'R'};
+const uint32_t RECORDING_VERSION = 1;
+/* Far above what a frame polls : a larger count means a corrupted file */
+const uint32_t MAX_FRAME_EVENTS = 1 << 16;
+
+struct RecordingHeader {
+    std::array<char, 4> magic;
+    uint32_t version;
+    /* The events are stored as raw structures : only replayable with the same SDL
+     * version and ABI */
+    uint32_t eventSize;
+};
+
+struct FrameHeader {
+    float deltaT;
+    uint32_t eventCount;
+};
+
+bool isReplayable(const SDL_Event& event)
+{
+    switch (event.type)
+    {
+    case SDL_DROPFILE:
+    case SDL_DROPTEXT:
+    case SDL_SYSWMEVENT:
+        return false;
+    default:
+        return event.type < SDL_USEREVENT;
+    }
+}
+
+} // namespace
+
+namespace experim {
+
+/* ------------------------------------------- */
+/* InputRecorder                               */
+/* ------------------------------------------- */
+
+InputRecorder::InputRecorder(const std::string& filePath)
+    : file_(filePath, std::ios::out | std::ios::binary | std::ios::trunc)
+    , recordedFrames_(0)
+    , logger_(spdlog::get(LOGGER_NAME))
+{
+    if (!file_.is_open())
+    {
+        SPDLOG_LOGGER_ERROR(logger_, "Failed to open recording file {}", filePath);
+        return;
+    }
+
+    RecordingHeader header {
+        .magic = RECORDING_MAGIC,
+        .version = RECORDING_VERSION,
+        .eventSize = sizeof(SDL_Event)};
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    SPDLOG_LOGGER_INFO(logger_, "Input recording started : {}", filePath);
+}
+
+InputRecorder::~InputRecorder()
+{
+    if (file_.is_open())
+    {
+        SPDLOG_LOGGER_INFO(
+            logger_, "Input recording ended : {} frame(s)", recordedFrames_);
+    }
+}
+
+void InputRecorder::record(const FrameInput& input)
+{
+    if (!file_.is_open())
+        return;
+
+    uint32_t eventCount = 0;
+    for (const auto& event : input.events)
+    {
+        if (isReplayable(event))
+            eventCount++;
+    }
+
+    FrameHeader frameHeader {.deltaT = input.deltaT, .eventCount = eventCount};
+    file_.write(reinterpret_cast<const char*>(&frameHeader), sizeof(frameHeader));
+    for (const auto& event : input.events)
+    {
+        if (isReplayable(event))
+            file_.write(reinterpret_cast<const char*>(&event), sizeof(event));
+    }
+    recordedFrames_++;
+}
+
+/* ------------------------------------------- */
+/* InputReplayer                               */
+/* ------------------------------------------- */
+
+InputReplayer::InputReplayer(const std::string& filePath)
+    : file_(filePath, std::ios::in | std::ios::binary)
+    , replayedFrames_(0)
+    , logger_(spdlog::get(LOGGER_NAME))
+{
+    if (!file_.is_open())
+    {
+        SPDLOG_LOGGER_ERROR(logger_, "Failed to open recording file {}", filePath);
+        return;
+    }
+
+    RecordingHeader header;
+    file_.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file_ || header.magic != RECORDING_MAGIC
+        || header.version != RECORDING_VERSION
+        || header.eventSize != sizeof(SDL_Event))
+    {
+        SPDLOG_LOGGER_ERROR(
+            logger_, "{} is not a compatible input recording", filePath);
+        file_.close();
+        return;
+    }
+
+    SPDLOG_LOGGER_INFO(logger_, "Input replay started : {}", filePath);
+}
+
+bool InputReplayer::next(FrameInput& input)
+{
+    if (!file_.is_open())
+        return false;
+
+    FrameHeader frameHeader;
+    file_.read(reinterpret_cast<char*>(&frameHeader), sizeof(frameHeader));
+    if (!file_)
+        return false;
+
+    /* The events are only allocated once their count is known to be in the file */
+    const auto position = file_.tellg();
+    file_.seekg(0, std::ios::end);
+    const auto remainingBytes = static_cast<uint64_t>(file_.tellg() - position);
+    file_.seekg(position);
+    if (!file_ || frameHeader.eventCount > MAX_FRAME_EVENTS
+        || frameHeader.eventCount * sizeof(SDL_Event) > remainingBytes
+        || !std::isfinite(frameHeader.deltaT) || frameHeader.deltaT < 0.0f)
+    {
+        SPDLOG_LOGGER_WARN(
+            logger_, "Corrupted input recording after {} frame(s)", replayedFrames_);
+        file_.close();
+        return false;
+    }
+
+    input.deltaT = frameHeader.deltaT;
+    input.events.resize(frameHeader.eventCount);
+    file_.read(
+        reinterpret_cast<char*>(input.events.data()),
+        frameHeader.eventCount * sizeof(SDL_Event));
+    if (!file_)
+    {
+        SPDLOG_LOGGER_WARN(
+            logger_, "Truncated input recording after {} frame(s)", replayedFrames_);
+        return false;
+    }
+
+    replayedFrames_++;
+    return true;
+}
+
+} // namespace experim
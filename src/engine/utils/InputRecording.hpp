@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <SDL2/SDL_events.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace experim {
+
+/** Input of one frame : the SDL events polled during the frame and the elapsed time
+ * used to update the simulation. */
+struct FrameInput {
+    float deltaT = 0.0f;
+    std::vector<SDL_Event> events;
+};
+
+/** Writes the input of each frame to a binary file, which can be replayed by an
+ * InputReplayer.
+ * File layout : header, then per frame the deltaT, the event count and the raw
+ * SDL_Event structures. Events holding pointers (dropped files, user events, window
+ * manager messages) are not recorded since they can't be replayed. */
+class InputRecorder {
+public:
+    InputRecorder(const std::string& filePath);
+    ~InputRecorder();
+
+    inline bool isOpen() const { return file_.is_open(); };
+    inline uint64_t recordedFrames() const { return recordedFrames_; };
+
+    void record(const FrameInput& input);
+
+private:
+    std::ofstream file_;
+    uint64_t recordedFrames_;
+
+    /* Logging */
+    std::shared_ptr<spdlog::logger> logger_;
+};
+
+/** Reads back, frame by frame, a file written by an InputRecorder. */
+class InputReplayer {
+public:
+    InputReplayer(const std::string& filePath);
+
+    inline bool isOpen() const { return file_.is_open(); };
+    inline uint64_t replayedFrames() const { return replayedFrames_; };
+
+    /** Fills input with the next recorded frame. Returns false at the end of the
+     * recording. */
+    bool next(FrameInput& input);
+
+private:
+    std::ifstream file_;
+    uint64_t replayedFrames_;
+
+    /* Logging */
+    std::shared_ptr<spdlog::logger> logger_;
+};
+
+} // namespace experim
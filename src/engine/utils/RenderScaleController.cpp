@@ -0,0 +1,97 @@
+#include "RenderScaleController.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/* Frames measured at the current scale before changing it again */
+const uint32_t SETTLE_FRAMES = 8;
+/* Weight of the last frame in the average duration */
+const double DURATION_SMOOTHING = 0.2;
+/* Below this fraction of the budget, the scale is raised. Keeps the scale from
+ * oscillating around the budget. */
+const double RAISE_THRESHOLD = 0.85;
+/* Largest change of the scale at once */
+const float MAX_SCALE_STEP = 0.1f;
+/* Scales are rounded to multiples of it, so that tiny changes are skipped */
+const float SCALE_GRANULARITY = 1.0f / 64.0f;
+const float MIN_RENDER_SCALE = SCALE_GRANULARITY;
+
+} // namespace
+
+namespace experim {
+
+RenderScaleController::RenderScaleController()
+    : targetDuration_(0.0)
+    , minScale_(1.0f)
+    , maxScale_(1.0f)
+    , scale_(1.0f)
+    , averageScaledDuration_(0.0)
+    , averageFixedDuration_(0.0)
+    , measuredFrames_(0)
+{
+}
+
+void RenderScaleController::setTargetFrameDuration(double milliseconds)
+{
+    targetDuration_ = std::max(0.0, milliseconds);
+    if (targetDuration_ == 0.0)
+        scale_ = maxScale_;
+    measuredFrames_ = 0;
+}
+
+void RenderScaleController::setScaleRange(float minScale, float maxScale)
+{
+    maxScale_ = std::clamp(maxScale, MIN_RENDER_SCALE, 1.0f);
+    minScale_ = std::clamp(minScale, MIN_RENDER_SCALE, maxScale_);
+    scale_ = std::clamp(scale_, minScale_, maxScale_);
+}
+
+float RenderScaleController::update(double scaledDuration, double fixedDuration)
+{
+    if (targetDuration_ == 0.0 || scaledDuration <= 0.0)
+        return scale_;
+    fixedDuration = std::max(0.0, fixedDuration);
+
+    if (measuredFrames_ == 0)
+    {
+        averageScaledDuration_ = scaledDuration;
+        averageFixedDuration_ = fixedDuration;
+    }
+    else
+    {
+        averageScaledDuration_
+            += DURATION_SMOOTHING * (scaledDuration - averageScaledDuration_);
+        averageFixedDuration_
+            += DURATION_SMOOTHING * (fixedDuration - averageFixedDuration_);
+    }
+    measuredFrames_++;
+    if (measuredFrames_ < SETTLE_FRAMES)
+        return scale_;
+
+    const double scaledBudget = targetDuration_ - averageFixedDuration_;
+    if (scaledBudget <= 0.0)
+        return scale_;
+
+    if (averageScaledDuration_ > scaledBudget
+        || averageScaledDuration_ < scaledBudget * RAISE_THRESHOLD)
+    {
+        /* The duration follows the pixel count */
+        const float idealScale = static_cast<float>(
+            scale_ * std::sqrt(scaledBudget / averageScaledDuration_));
+        float scale = std::clamp(
+            idealScale, scale_ - MAX_SCALE_STEP, scale_ + MAX_SCALE_STEP);
+        scale = std::round(scale / SCALE_GRANULARITY) * SCALE_GRANULARITY;
+        scale = std::clamp(scale, minScale_, maxScale_);
+        if (scale != scale_)
+        {
+            scale_ = scale;
+            /* The previous measures do not apply to the new scale */
+            measuredFrames_ = 0;
+        }
+    }
+    return scale_;
+}
+
+} // namespace experim
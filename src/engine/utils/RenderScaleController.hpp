@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+namespace experim {
+
+/** Adjusts a render scale so that the measured GPU frame duration stays within a
+ * budget. A frame is measured in two parts : the scaled part, whose cost is
+ * assumed to grow with the rendered pixel count (the square of the scale, which
+ * applies to both axes), and the fixed part (native resolution passes, upscale),
+ * which the scale can't reduce. The scaled part gets the budget left by the fixed
+ * one. The measures lag a few frames behind the scale they were rendered at, so
+ * the scale only changes once a few frames were measured since the previous
+ * change. */
+class RenderScaleController {
+public:
+    RenderScaleController();
+
+    /** A budget (in ms) of 0 disables the adjustment : the scale goes back to the
+     * maximum. */
+    void setTargetFrameDuration(double milliseconds);
+    /** Clamped to ]0, 1] */
+    void setScaleRange(float minScale, float maxScale);
+
+    /** Feeds the GPU durations (in ms) of a completed frame, and returns the scale
+     * of the next frames. While the fixed part alone exceeds the budget, the scale
+     * is kept : lowering it can't meet the budget. */
+    float update(double scaledDuration, double fixedDuration);
+    inline float scale() const { return scale_; };
+
+private:
+    /* Configuration */
+    double targetDuration_;
+    float minScale_;
+    float maxScale_;
+
+    /* State */
+    float scale_;
+    /* Moving averages of the frames measured since the last change */
+    double averageScaledDuration_;
+    double averageFixedDuration_;
+    uint32_t measuredFrames_;
+};
+
+} // namespace experim